@@ -0,0 +1,148 @@
+#pragma once
+
+#include <format.h>
+#include <platform.h>
+#include <suite.h>
+
+// Measurement and reporting for the benchmark runners (`bench/host.cc`,
+// `bench/qemu/main.cc`); each supplies a clock and somewhere to write text.
+//
+// A `Clock` has `static uint32_t now()` and `static uint32_t since(uint32_t t0)`, in
+// whatever units it likes (nanoseconds on the host, SysTick ticks on QEMU).  Reports
+// are per operation (see `Bench::ops`) and take a `scale10`: output units, in tenths,
+// per clock unit.  All of this sticks to 32-bit arithmetic, so it needs no runtime
+// support on the M33.
+
+namespace bench {
+
+constexpr static unsigned kMaxReps = 64;
+
+struct Options {
+    unsigned warmup = 2; // untimed calls first, to settle caches, heap state etc.
+    unsigned reps = 32;  // timed calls; at most `kMaxReps`
+};
+
+// Times per call of one benchmark, in clock units
+struct Result {
+    Bench const* bench;
+    unsigned reps;
+    uint32_t min;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;
+};
+
+template <class Clock> Result measure(Bench const& b, Options const& opts = {}) {
+    uint32_t samples[kMaxReps];
+    auto reps = opts.reps < kMaxReps ? opts.reps : kMaxReps;
+    for (unsigned i = 0; i < opts.warmup; i++) { b.run(); }
+    for (unsigned i = 0; i < reps; i++) {
+        auto t0 = Clock::now();
+        b.run();
+        samples[i] = Clock::since(t0);
+    }
+    // Insertion sort; `reps` is small
+    for (unsigned i = 1; i < reps; i++) {
+        auto x = samples[i];
+        auto j = i;
+        for (; j && samples[j - 1] > x; --j) { samples[j] = samples[j - 1]; }
+        samples[j] = x;
+    }
+    auto pct = [&](unsigned p) { return samples[((reps - 1) * p) / 100]; };
+    return {
+        .bench = &b,
+        .reps = reps,
+        .min = samples[0],
+        .p50 = pct(50),
+        .p90 = pct(90),
+        .p99 = pct(99),
+        .max = samples[reps - 1],
+    };
+}
+
+// Line-buffered text output; `kWrite` gets one NUL-terminated line at a time.
+template <void (*kWrite)(char const*)> struct Out {
+    char buf_[128];
+    unsigned n_ {};
+
+    void flush() {
+        buf_[n_] = 0;
+        kWrite(buf_);
+        n_ = 0;
+    }
+
+    Out& operator<<(char c) {
+        buf_[n_++] = c;
+        if (c == '\n' || n_ == sizeof(buf_) - 1) { flush(); }
+        return *this;
+    }
+
+    Out& operator<<(char const* s) {
+        while (*s) { *this << *s++; }
+        return *this;
+    }
+
+    Out& operator<<(uint32_t x) {
+        char digits[10];
+        auto* end = rp2350::formatDec(digits, x);
+        for (auto* p = digits; p < end; ++p) { *this << *p; }
+        return *this;
+    }
+
+    // Pad with spaces to column `col`
+    Out& pad(unsigned col) {
+        while (n_ < col) { *this << ' '; }
+        return *this;
+    }
+
+    // `tenths` / 10, with one decimal place
+    Out& fixed(uint32_t tenths) {
+        return *this << uint32_t(tenths / 10) << '.' << char('0' + (tenths % 10));
+    }
+};
+
+// Per-op figure for a time `t` of `r`, in tenths of output units
+inline uint32_t perOp(Result const& r, uint32_t t, uint32_t scale10) {
+    return (t * scale10) / r.bench->ops;
+}
+
+// A header line naming the unit, then one aligned line per result, e.g.:
+//   memcpy.aligned.4k       min 503.0       p50 505.0       p90 507.0       max 582.0
+template <class O> void tableHeader(O& out, char const* unit) {
+    out << "benchmark";
+    out.pad(24) << "per op, in " << unit << '\n';
+}
+
+template <class O> void tableRow(O& out, Result const& r, uint32_t scale10) {
+    out << r.bench->name;
+    out.pad(24) << "min ";
+    out.fixed(perOp(r, r.min, scale10)).pad(40) << "p50 ";
+    out.fixed(perOp(r, r.p50, scale10)).pad(56) << "p90 ";
+    out.fixed(perOp(r, r.p90, scale10)).pad(72) << "max ";
+    out.fixed(perOp(r, r.max, scale10)) << '\n';
+}
+
+// JSON: one object, with every result's per-op figures, e.g.
+//   {"target":"host","unit":"ns","results":[
+//    {"name":"pool","ops":128,"reps":32,"min":9.5,"p50":9.6,...},
+//   ...]}
+template <class O> void jsonBegin(O& out, char const* target, char const* unit) {
+    out << "{\"target\":\"" << target << "\",\"unit\":\"" << unit
+        << "\",\"results\":[\n";
+}
+
+template <class O>
+void jsonResult(O& out, Result const& r, uint32_t scale10, bool last) {
+    out << " {\"name\":\"" << r.bench->name << "\",\"ops\":" << uint32_t(r.bench->ops)
+        << ",\"reps\":" << uint32_t(r.reps) << ",\"min\":";
+    out.fixed(perOp(r, r.min, scale10)) << ",\"p50\":";
+    out.fixed(perOp(r, r.p50, scale10)) << ",\"p90\":";
+    out.fixed(perOp(r, r.p90, scale10)) << ",\"p99\":";
+    out.fixed(perOp(r, r.p99, scale10)) << ",\"max\":";
+    out.fixed(perOp(r, r.max, scale10)) << (last ? "}\n" : "},\n");
+}
+
+template <class O> void jsonEnd(O& out) { out << "]}\n"; }
+
+} // namespace bench
@@ -0,0 +1,188 @@
+#include <bench.h>
+#include <mpmc.h>
+#include <platform.h>
+#include <suite.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Native benchmark runner (see `make bench-host`): the same suite as on QEMU, built
+// with `-DRP2350_HOST` for the host CPU.  Figures are nanoseconds per operation, so
+// they're only comparable with other runs on the same machine; this is for spotting
+// algorithmic regressions quickly, not for Thumb-2 code quality.
+//
+// Besides the shared suite, this runs the benchmarks needing threads: contention on
+// `MpmcQueue`, lock-free and with a lock (standing in for a hardware spinlock).
+//
+// Usage: `host [--json] [name-prefix]`; `--json` prints only the JSON report.
+
+using namespace bench;
+
+namespace {
+
+void writeStdout(char const* s) { fputs(s, stdout); }
+
+Out<writeStdout> out;
+
+struct MonotonicClock {
+    static uint32_t now() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return uint32_t(ts.tv_sec) * 1'000'000'000u + uint32_t(ts.tv_nsec);
+    }
+    static uint32_t since(uint32_t t0) { return now() - t0; }
+};
+
+// A test-and-set lock, like the SIO spinlocks; for `MpmcQueue`'s locked flavour
+struct SpinLock {
+    bool held_ {};
+
+    void lock() {
+        while (__atomic_test_and_set(&held_, __ATOMIC_ACQUIRE)) {}
+    }
+    void unlock() { __atomic_clear(&held_, __ATOMIC_RELEASE); }
+};
+
+constexpr static unsigned kContendedItems = 20000; // per thread
+
+SpinLock queueLock;
+rp2350::MpmcQueue<uint32_t, 64> sharedQueue;
+rp2350::MpmcQueue<uint32_t, 64, SpinLock> lockedQueue {&queueLock};
+
+// Threads for the contended benchmarks, started before any of them is timed, so that a
+// timed call covers only the push/pop loops: `run` releases the workers it needs
+// through `start_`, runs its own share on the calling thread, and waits for theirs at
+// `done_`.  (Workers sitting a job out still pass both barriers.)
+struct Crew {
+    constexpr static unsigned kWorkers = 3; // besides the calling thread
+
+    struct Worker {
+        Crew* crew;
+        unsigned index;
+        pthread_t thread;
+    };
+
+    Worker workers_[kWorkers];
+    pthread_barrier_t start_;
+    pthread_barrier_t done_;
+    void (*job_)(void*) {};
+    void* arg_ {};
+    unsigned active_ {}; // workers taking part in the current job
+    bool quit_ {};
+
+    static void* work(void* arg) {
+        auto& [crew, index, _] = *(Worker*)arg;
+        while (true) {
+            pthread_barrier_wait(&crew->start_);
+            if (crew->quit_) { return nullptr; }
+            if (index < crew->active_) { crew->job_(crew->arg_); }
+            pthread_barrier_wait(&crew->done_);
+        }
+    }
+
+    void begin() {
+        pthread_barrier_init(&start_, nullptr, kWorkers + 1);
+        pthread_barrier_init(&done_, nullptr, kWorkers + 1);
+        for (unsigned i = 0; i < kWorkers; i++) {
+            workers_[i] = {this, i, {}};
+            pthread_create(&workers_[i].thread, nullptr, work, &workers_[i]);
+        }
+    }
+
+    void end() {
+        quit_ = true;
+        pthread_barrier_wait(&start_);
+        for (auto& w : workers_) { pthread_join(w.thread, nullptr); }
+        pthread_barrier_destroy(&start_);
+        pthread_barrier_destroy(&done_);
+    }
+
+    // Run `job(arg)` on `threads` threads at once (at most `kWorkers + 1`)
+    void run(void (*job)(void*), void* arg, unsigned threads) {
+        job_ = job;
+        arg_ = arg;
+        active_ = threads - 1;
+        pthread_barrier_wait(&start_);
+        job(arg);
+        pthread_barrier_wait(&done_);
+    }
+};
+
+Crew crew;
+
+// Each thread pushes an item and pops one (maybe another's), `kContendedItems` times
+template <class Q> void contender(void* queue) {
+    auto& q = *(Q*)queue;
+    uint32_t x;
+    for (uint32_t i = 0; i < kContendedItems; i++) {
+        while (!q.tryPush(opaque(i))) {}
+        while (!q.tryPop(x)) {}
+    }
+    keep(&x);
+}
+
+template <class Q, unsigned kThreads> void contended(Q& q) {
+    static_assert(kThreads <= Crew::kWorkers + 1);
+    crew.run(contender<Q>, &q, kThreads);
+}
+
+template <unsigned kThreads> void mpmcContended() {
+    contended<decltype(sharedQueue), kThreads>(sharedQueue);
+}
+
+template <unsigned kThreads> void mpmcLocked() {
+    contended<decltype(lockedQueue), kThreads>(lockedQueue);
+}
+
+Bench const kHostSuite[] {
+    {"mpmc.contended.1t", 2 * kContendedItems, mpmcContended<1>},
+    {"mpmc.contended.2t", 4 * kContendedItems, mpmcContended<2>},
+    {"mpmc.contended.4t", 8 * kContendedItems, mpmcContended<4>},
+    {"mpmc.locked.1t", 2 * kContendedItems, mpmcLocked<1>},
+    {"mpmc.locked.2t", 4 * kContendedItems, mpmcLocked<2>},
+    {"mpmc.locked.4t", 8 * kContendedItems, mpmcLocked<4>},
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    constexpr static unsigned kCount = sizeof(kSuite) / sizeof(kSuite[0]) +
+                                       sizeof(kHostSuite) / sizeof(kHostSuite[0]);
+    static Result results[kCount];
+
+    bool json = false;
+    char const* prefix = "";
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--json")) {
+            json = true;
+        } else {
+            prefix = argv[i];
+        }
+    }
+
+    unsigned n = 0;
+    auto run = [&](Bench const& b, Options const& opts) {
+        if (strncmp(b.name, prefix, strlen(prefix))) { return; }
+        results[n] = measure<MonotonicClock>(b, opts);
+        if (!json) {
+            if (!n) { tableHeader(out, "ns"); }
+            tableRow(out, results[n], 10);
+        }
+        ++n;
+    };
+    for (auto const& b : kSuite) { run(b, {.warmup = 4, .reps = kMaxReps}); }
+    crew.begin();
+    for (auto const& b : kHostSuite) { run(b, {.warmup = 1, .reps = 8}); }
+    crew.end();
+
+    if (json) {
+        jsonBegin(out, "host", "ns");
+        for (unsigned i = 0; i < n; i++) {
+            jsonResult(out, results[i], 10, i == n - 1);
+        }
+        jsonEnd(out);
+    }
+    return n ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#include <bench.h>
+#include <platform.h>
+#include <qemu/semihost.h>
+#include <rp2350/common.h>
+#include <rp2350/m33.h>
+#include <rp2350/reset.h>
+#include <suite.h>
+
+// Benchmark runner for QEMU's `mps2-an505` board (a Cortex-M33; see `make bench-qemu`).
+// Only core M33 features are used: the SysTick timer for timing, and semihosting for
+// output.  `__reset` from `rp2350/reset.h` does the usual `.bss` / `.data` setup; the
+// board's memory map is in `bench/qemu/layout.ld`.
+//
+// QEMU runs with `-icount shift=0`: each instruction advances virtual time by 1ns, and
+// SysTick ticks on that virtual clock, so elapsed ticks measure instructions executed.
+// (This counts instructions, not cycles: loads, branches and multiplies all count 1.)
+
+using namespace bench;
+using rp2350::m33;
+
+namespace {
+
+constexpr uint32_t kTickMask = 0x00ffffff;
+
+Out<semihost::write0> out;
+
+// SysTick counts down from `kTickMask`; turn that into an up-counter
+struct SysTickClock {
+    static uint32_t now() { return kTickMask - *(uint32_t volatile*)&m33.cvr(); }
+    static uint32_t since(uint32_t t0) { return (now() - t0) & kTickMask; }
+};
+
+void startClock() {
+    m33.rvr() = kTickMask;
+    m33.cvr() = 0;
+    rp2350::overwrite(&m33.csr(), [](auto& _) {
+        _->enable = 1;
+        _->source = unsigned(rp2350::M33::ClockSource::PROC_CLK);
+    });
+}
+
+// Instructions per tick (in tenths), from a loop of known length
+uint32_t calibrate() {
+    constexpr uint32_t kLoops = 1 << 18;
+    uint32_t n = kLoops;
+    auto t0 = SysTickClock::now();
+    asm volatile("1: subs %0, #1\n bne 1b" : "+r"(n));
+    auto ticks = SysTickClock::since(t0);
+    return ticks ? (2 * kLoops * 10) / ticks : 0;
+}
+
+} // namespace
+
+extern "C" {
+
+// Any fault (including a UBSan trap) ends the run with a failure status
+[[gnu::used]] [[gnu::retain]] [[noreturn]] void __benchFault() {
+    semihost::write0("bench: fault\n");
+    semihost::exit(false);
+}
+
+void __start() {
+    constexpr static unsigned kCount = sizeof(kSuite) / sizeof(kSuite[0]);
+    static Result results[kCount];
+
+    startClock();
+    auto insnsPerTick10 = calibrate();
+    out << "mps2-an505: ";
+    out.fixed(insnsPerTick10) << " insns/tick\n";
+
+    tableHeader(out, "insns");
+    for (unsigned i = 0; i < kCount; i++) {
+        results[i] = measure<SysTickClock>(kSuite[i]);
+        tableRow(out, results[i], insnsPerTick10);
+    }
+
+    jsonBegin(out, "mps2-an505", "insns");
+    for (unsigned i = 0; i < kCount; i++) {
+        jsonResult(out, results[i], insnsPerTick10, i == kCount - 1);
+    }
+    jsonEnd(out);
+
+    semihost::exit(true);
+}
+
+} // extern "C"
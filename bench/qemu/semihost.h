@@ -0,0 +1,33 @@
+#pragma once
+
+#include <platform.h>
+
+namespace bench::semihost {
+
+// ARM semihosting: a `BKPT 0xAB` with the operation in r0 and its argument in r1 is
+// trapped by the debugger or, here, by QEMU (run with `-semihosting`).
+// See "Semihosting for AArch32 and AArch64", https://github.com/ARM-software/abi-aa
+enum Op : uint32_t {
+    WRITE0 = 0x04, // write a NUL-terminated string to the console
+    EXIT = 0x18,   // stop; on AArch32 the argument is the reason, not a parameter block
+};
+
+// Reasons for `EXIT`; QEMU exits with status 0 for the first, 1 for anything else
+constexpr static uint32_t kApplicationExit = 0x20026;
+constexpr static uint32_t kRunTimeErrorUnknown = 0x20023;
+
+[[gnu::always_inline]] inline uint32_t call(Op op, void const* arg) {
+    register uint32_t r0 asm("r0") = op;
+    register void const* r1 asm("r1") = arg;
+    asm volatile("bkpt 0xab" : "+r"(r0) : "r"(r1) : "memory");
+    return r0;
+}
+
+inline void write0(char const* s) { call(WRITE0, s); }
+
+[[noreturn]] inline void exit(bool ok) {
+    call(EXIT, (void const*)(ok ? kApplicationExit : kRunTimeErrorUnknown));
+    __unreachable();
+}
+
+} // namespace bench::semihost
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <format.h>
+#include <memory.h>
+#include <mpmc.h>
+#include <platform.h>
+#include <pool.h>
+#include <ring.h>
+#include <tmds.h>
+
+// Benchmark bodies for the hardware-independent parts of the library.  These are
+// shared by the runners (e.g. `bench/qemu/main.cc`), which only differ in how they
+// measure time and report results.
+
+namespace bench {
+
+struct Bench {
+    char const* name;
+    unsigned ops; // operations done by one call of `run`, for per-op figures
+    void (*run)();
+};
+
+// Hide `x` from the optimizer, so work depending on it can't be folded away
+template <class T> [[gnu::always_inline]] inline T opaque(T x) {
+    asm volatile("" : "+r"(x));
+    return x;
+}
+
+// Make the optimizer assume that memory at `p` (and anything else) is read
+[[gnu::always_inline]] inline void keep(void const* p) {
+    asm volatile("" : : "r"(p) : "memory");
+}
+
+namespace data {
+
+constexpr static size_t kBytes = 4096;
+constexpr static unsigned kPixels = 640;
+constexpr static unsigned kCount = 64; // allocations, formatted numbers, ...
+
+struct Node {
+    uint32_t v[4];
+};
+
+alignas(8) inline uint8_t src[kBytes + 8];
+alignas(8) inline uint8_t dst[kBytes + 8];
+alignas(8) inline uint8_t arena[32768];
+inline rp2350::Pixel pixels[kPixels];
+inline uint32_t words[kPixels];
+inline char text[kCount * 11];
+inline void* ptrs[kCount];
+inline rp2350::Heap heap;
+inline rp2350::Pool<Node, kCount> pool;
+inline rp2350::SpscRing<uint32_t, kCount> ring;
+inline rp2350::MpmcQueue<uint32_t, kCount> queue;
+
+inline rp2350::Heap& benchHeap() {
+    if (!heap.ready()) { heap.init(arena, arena + sizeof(arena)); }
+    return heap;
+}
+
+} // namespace data
+
+// mem*: whole-buffer operations, plus many small copies
+
+inline void memcpyAligned() {
+    __aeabi_memcpy(opaque(data::dst), opaque(data::src), data::kBytes);
+    keep(data::dst);
+}
+
+inline void memcpyShifted() {
+    __aeabi_memcpy(opaque(data::dst), opaque(data::src + 1), data::kBytes);
+    keep(data::dst);
+}
+
+// The byte loop the copy engine replaces, as a baseline for the two above (`opaque`
+// stops the compiler from turning it back into a `memcpy` call, or vectorizing it)
+inline void memcpyBytes() {
+    auto* d = opaque(data::dst);
+    auto const* s = opaque(data::src);
+    for (size_t i = 0; i < data::kBytes; i++) { d[i] = opaque(s[i]); }
+    keep(d);
+}
+
+inline void memcpySmall() {
+    auto* d = opaque(data::dst);
+    auto* s = opaque(data::src);
+    for (unsigned i = 0; i < data::kCount; i++) {
+        __aeabi_memcpy(d + (i & 7), s + ((i * 3) & 7), opaque(size_t(16)));
+    }
+    keep(d);
+}
+
+inline void memmoveOverlap() {
+    __aeabi_memmove(opaque(data::dst + 4), opaque(data::dst), data::kBytes);
+    keep(data::dst);
+}
+
+inline void memsetBytes() {
+    __aeabi_memset(opaque(data::dst), data::kBytes, opaque(0x5a));
+    keep(data::dst);
+}
+
+// Allocators and containers: allocate a batch, then free it all
+
+inline void heapSmall() {
+    auto& heap = data::benchHeap();
+    for (auto& p : data::ptrs) { p = heap.alloc(opaque(size_t(24))); }
+    for (auto* p : data::ptrs) { heap.free(p); }
+}
+
+inline void heapMixed() {
+    constexpr static size_t kSizes[] {16, 40, 300, 24, 1024, 96, 512, 8};
+    auto& heap = data::benchHeap();
+    for (unsigned i = 0; i < data::kCount; i++) {
+        data::ptrs[i] = heap.alloc(opaque(kSizes[i & 7]));
+    }
+    // Free every other block first, so the rest coalesce with free neighbours
+    for (unsigned i = 0; i < data::kCount; i += 2) { heap.free(data::ptrs[i]); }
+    for (unsigned i = 1; i < data::kCount; i += 2) { heap.free(data::ptrs[i]); }
+}
+
+inline void poolCycle() {
+    for (auto& p : data::ptrs) { p = data::pool.alloc(); }
+    for (auto* p : data::ptrs) { data::pool.free(p); }
+}
+
+// Rings: fill and drain, an item at a time and in bulk.  The bulk case first moves
+// the ring's position on by one, so its copies (mostly) wrap around the end.
+
+inline void ringPushPop() {
+    auto& ring = data::ring;
+    for (uint32_t i = 0; i < data::kCount; i++) { ring.push(opaque(i)); }
+    for (uint32_t i = 0; i < data::kCount; i++) { ring.pop(data::words[i]); }
+    keep(data::words);
+}
+
+inline void ringBulk() {
+    auto& ring = data::ring;
+    ring.push(0);
+    uint32_t x;
+    ring.pop(x);
+    ring.write({opaque(data::words), data::kCount});
+    ring.read({data::words + data::kCount, data::kCount});
+    keep(data::words);
+}
+
+// The same through the MPMC queue, uncontended (see `bench/host.cc` for contention):
+// the cost of its compare-and-swaps over the SPSC ring's plain stores
+
+inline void mpmcPushPop() {
+    auto& queue = data::queue;
+    for (uint32_t i = 0; i < data::kCount; i++) { queue.tryPush(opaque(i)); }
+    for (uint32_t i = 0; i < data::kCount; i++) { queue.tryPop(data::words[i]); }
+    keep(data::words);
+}
+
+// Pixels and TMDS: one line's worth each
+
+inline void pixelsClear() {
+    constexpr static rp2350::Pixel kGrey {.b = 2, .g = 2, .r = 2};
+    fill16(opaque(data::pixels), kGrey, data::kPixels);
+    keep(data::pixels);
+}
+
+inline void pixelsTestPattern() {
+    rp2350::testPattern(opaque(123u), opaque(data::pixels), 0, data::kPixels);
+    keep(data::pixels);
+}
+
+inline void tmdsTERC() {
+    using rp2350::TMDS;
+    auto const* px = opaque(data::pixels);
+    for (unsigned i = 0; i < data::kPixels; i++) {
+        TMDS t {
+            .ch0 = TMDS::kTERC[px[i].b].code,
+            .ch1 = TMDS::kTERC[px[i].g].code,
+            .ch2 = TMDS::kTERC[px[i].r].code,
+        };
+        data::words[i] = t.u32();
+    }
+    keep(data::words);
+}
+
+// Formatting
+
+inline void formatHex() {
+    auto* out = opaque(data::text);
+    for (uint32_t i = 0; i < data::kCount; i++) {
+        out = rp2350::formatHex(out, opaque(i * 0x9e3779b9u));
+    }
+    keep(data::text);
+}
+
+inline void formatDec() {
+    auto* out = opaque(data::text);
+    for (uint32_t i = 0; i < data::kCount; i++) {
+        // Mostly short numbers, with the occasional long one
+        out = rp2350::formatDec(out, opaque((i * 0x9e3779b9u) >> (i & 31)));
+    }
+    keep(data::text);
+}
+
+inline Bench const kSuite[] {
+    {"memcpy.aligned.4k", 1, memcpyAligned},
+    {"memcpy.shifted.4k", 1, memcpyShifted},
+    {"memcpy.bytes.4k", 1, memcpyBytes},
+    {"memcpy.16", data::kCount, memcpySmall},
+    {"memmove.overlap.4k", 1, memmoveOverlap},
+    {"memset.4k", 1, memsetBytes},
+    {"heap.small", 2 * data::kCount, heapSmall},
+    {"heap.mixed", 2 * data::kCount, heapMixed},
+    {"pool", 2 * data::kCount, poolCycle},
+    {"ring.item", 2 * data::kCount, ringPushPop},
+    {"ring.bulk", 2 * data::kCount, ringBulk},
+    {"mpmc.item", 2 * data::kCount, mpmcPushPop},
+    {"pixels.clear", data::kPixels, pixelsClear},
+    {"pixels.testPattern", data::kPixels, pixelsTestPattern},
+    {"tmds.terc", data::kPixels, tmdsTERC},
+    {"format.hex", data::kCount, formatHex},
+    {"format.dec", data::kCount, formatDec},
+};
+
+} // namespace bench
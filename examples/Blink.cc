@@ -44,19 +44,24 @@ using namespace rp2350;
 
     // p569: SDK expects nominal 1uS system ticks, as does Arm internals.
     // Although we don't use the SDK we'll assume 1uS everywhere as well.
-    ticks.proc0.control.enabled = false; // disable while configuring
-    ticks.proc0.cycles.count = 12;
-    ticks.proc0.control.enabled = true;
-    ticks.proc1.control.enabled = false; // disable while configuring
-    ticks.proc1.cycles.count = 12;
-    ticks.proc1.control.enabled = true;
+    // (Disable each while configuring it)
+    overwrite(&ticks.proc0.control, [](auto& _) { _->enabled = false; });
+    overwrite(&ticks.proc0.cycles, [](auto& _) { _->count = 12; });
+    overwrite(&ticks.proc0.control, [](auto& _) { _->enabled = true; });
+    overwrite(&ticks.proc1.control, [](auto& _) { _->enabled = false; });
+    overwrite(&ticks.proc1.cycles, [](auto& _) { _->count = 12; });
+    overwrite(&ticks.proc1.control, [](auto& _) { _->enabled = true; });
 
-    m33.ccr().unalignedTrap = true;
-    m33.ccr().div0Trap = true;
+    update(&m33.ccr(), [](auto& _) {
+        _->unalignedTrap = true;
+        _->div0Trap = true;
+    });
 
     m33.rvr() = 1000;
-    m33.csr().enable = 1;
-    m33.csr().tickInt = 1;
+    update(&m33.csr(), [](auto& _) {
+        _->enable = 1;
+        _->tickInt = 1;
+    });
 
     resets.unreset(Resets::Bit::PADSBANK0);
     resets.unreset(Resets::Bit::IOBANK0);
@@ -0,0 +1,99 @@
+// Cycles spent clearing memory, measured on the device with the DWT cycle counter:
+//
+//   - "boot": `__reset`'s `.bss` clear (and its other phases), from `bootTimes`
+//   - "line.fill16": one 640-pixel HDMI line, as `Pixels::clear` in `HDMI.cc` does it,
+//     with the line word-aligned and (".odd") starting one pixel in
+//   - "line.loop": the same line a pixel at a time, as a plain loop would, for scale
+//   - "memclr.4k": 4kB of zeroes, as for `.bss`
+//
+// The figures are printed on UART0 every second, the boot line once.  Build with
+// `make EXAMPLE=FillCycles`.
+
+#include <platform.h>
+#include <rp2350/clocks.h>
+#include <rp2350/common.h>
+#include <rp2350/cycles.h>
+#include <rp2350/gpio.h>
+#include <rp2350/insns.h>
+#include <rp2350/interrupts.h>
+#include <rp2350/m33.h>
+#include <rp2350/pads.h>
+#include <rp2350/panic.h>
+#include <rp2350/reset.h>
+#include <rp2350/resets.h>
+#include <rp2350/uart.h>
+#include <rp2350/xoscpll.h>
+#include <tmds.h>
+
+namespace rp2350::sys {
+
+[[gnu::retain]] [[gnu::used]] [[gnu::section(
+    ".vec_table")]] ARMVectors const gARMVectors;
+
+[[gnu::retain]] [[gnu::used]] [[gnu::section(
+    ".image_def")]] constinit ImageDef2350ARM const gImageDef;
+
+} // namespace rp2350::sys
+
+using namespace rp2350;
+
+constexpr static unsigned kHActive = 640;
+constexpr static unsigned kRounds = 256;
+constexpr static Pixel kGrey {.b = 2, .g = 2, .r = 2};
+
+alignas(4) Pixel gLine[kHActive + 1];
+alignas(4) uint8_t gBlock[4096];
+
+constinit CycleCounter gFill16 {"line.fill16"};
+constinit CycleCounter gFill16Odd {"line.fill16.odd"};
+constinit CycleCounter gLoop {"line.loop"};
+constinit CycleCounter gMemclr {"memclr.4k"};
+
+void measure() {
+    for (unsigned i = 0; i < kRounds; i++) {
+        {
+            ScopedCycles _ {gFill16};
+            fill16(gLine, kGrey, kHActive);
+        }
+        {
+            ScopedCycles _ {gFill16Odd};
+            fill16(gLine + 1, kGrey, kHActive);
+        }
+        {
+            ScopedCycles _ {gLoop};
+            auto* p = (uint16_t volatile*)gLine; // (one store per pixel, kept as such)
+            auto px = __builtin_bit_cast(uint16_t, kGrey);
+            for (unsigned j = 0; j < kHActive; j++) { p[j] = px; }
+        }
+        {
+            ScopedCycles _ {gMemclr};
+            __aeabi_memclr4(gBlock, sizeof(gBlock));
+        }
+    }
+}
+
+[[gnu::retain]] [[gnu::used]] [[gnu::noreturn]] [[gnu::noinline]] void __start() {
+    initSystemClock();
+    initRefClock();
+    initPeriphClock();
+    initCPUBasic();
+
+    resets.unreset(Resets::Bit::PADSBANK0);
+    resets.unreset(Resets::Bit::IOBANK0);
+    initOutput<0>(GPIO::FuncSel<0>::UART0TX);
+    initInput<1>(GPIO::FuncSel<1>::UART0RX);
+    resets.unreset(Resets::Bit::UART0);
+    uart0.init(kSysHz, 115200);
+
+    // (Boot cycles are at the bootrom's clock, before `initSystemClock`)
+    uart0.write("cycles in __reset, by phase:\n");
+    dumpBootTimes([](char const* s) { uart0.write(s); });
+
+    while (true) {
+        resetCycleCounters();
+        measure();
+        uart0.write("fills, cycles:\n");
+        dumpCycles([](char const* s) { uart0.write(s); });
+        for (unsigned i = 0; i < kSysHz / 4; i++) { __nop(); }
+    }
+}
@@ -8,8 +8,10 @@
 #include <rp2350/pads.h>
 #include <rp2350/panic.h>
 #include <rp2350/resets.h>
+#include <rp2350/sram.h>
 #include <rp2350/ticks.h>
 #include <rp2350/uart.h>
+#include <tmds.h>
 
 // For 640x480 at appx. 60fps
 static_assert(rp2350::kSysHz == 126'000'000);
@@ -36,81 +38,13 @@ namespace rp2350::sys {
 
 } // namespace rp2350::sys
 
-struct TERC {
-    unsigned code : 10;
-    constexpr operator unsigned() const { return unsigned(code); };
-};
-
-struct [[gnu::packed]] TMDS {
-    unsigned ch0 : 10 {};
-    unsigned ch1 : 10 {};
-    unsigned ch2 : 10 {};
-    unsigned     : 2;
-
-    constexpr uint32_t u32() const {
-        return (unsigned(ch2) << 20) | (unsigned(ch1) << 10) | (unsigned(ch0) << 0);
-    }
-
-    // Encode 6 bits (2 bits across 3 channels)
-    constexpr static TMDS control(uint8_t ch2, uint8_t ch1, uint8_t ch0) {
-        return {
-            .ch0 = kControl[ch0 & 0x03].code,
-            .ch1 = kControl[ch1 & 0x03].code,
-            .ch2 = kControl[ch2 & 0x03].code,
-        };
-    }
-
-    // Encode 6 bits (2 bits across 3 channels): CTL3..0, plus set CH0 ctl bits for sync
-    constexpr static TMDS control(uint8_t ch2, uint8_t ch1, bool vsync, bool hsync) {
-        uint8_t v = vsync ? 0b10 : 0b00;
-        uint8_t h = hsync ? 0b01 : 0b00;
-        return control(ch2, ch1, v | h);
-    }
-
-    constexpr static TMDS idle() { return control(0x00, 0x00, 0x00); }
-
-    constexpr static TMDS sync(bool vsync, bool hsync) {
-        return control(0x00, 0x00, vsync, hsync);
-    }
-
-    constexpr static TMDS hsync() { return control(0x00, 0x00, false, true); }
-
-    // For encoding 4 data bits
-    constexpr static TERC kTERC[16] {
-        {.code = 0b1010011100}, {.code = 0b1001100011}, {.code = 0b1011100100},
-        {.code = 0b1011100010}, {.code = 0b0101110001}, {.code = 0b0100011110},
-        {.code = 0b0110001110}, {.code = 0b0100111100}, {.code = 0b1011001100},
-        {.code = 0b0100111001}, {.code = 0b0110011100}, {.code = 0b1011000110},
-        {.code = 0b1010001110}, {.code = 0b1001110001}, {.code = 0b0101100011},
-        {.code = 0b1011000011},
-    };
-
-    // For encoding 2 control bits:
-    // CH0: D0=HSYNC  D1=VSYNC
-    // CH1: D0=CTL0   D1=CTL1
-    // CH2: D0=CTL2   D1=CTL3
-    constexpr static TERC kControl[4] {
-        {.code = 0b1101010100},
-        {.code = 0b0010101011},
-        {.code = 0b0101010100},
-        {.code = 0b1010101011},
-    };
-};
-static_assert(sizeof(TMDS) == 4);
-
-// RGB444
-struct [[gnu::packed]] Pixel {
-    unsigned b : 4 {};
-    unsigned g : 4 {};
-    unsigned r : 4 {};
-};
-static_assert(sizeof(Pixel) == 2);
-
 namespace rp2350::sys {
 
 void initCPUBasic() {
-    m33.ccr().unalignedTrap = true;
-    m33.ccr().div0Trap = true;
+    update(&m33.ccr(), [](auto& _) {
+        _->unalignedTrap = true;
+        _->div0Trap = true;
+    });
 }
 
 void initSystemClock() {
@@ -145,16 +79,18 @@ void initHSTXClock() {
 
 void initSystemTicks() {
     // p569: SDK as well as Arm CPU expect nominal 1uS system ticks
-    ticks.proc0.control.enabled = false;
-    ticks.proc0.cycles.count = 12;
-    ticks.proc0.control.enabled = true;
-    ticks.proc1.control.enabled = false;
-    ticks.proc1.cycles.count = 12;
-    ticks.proc1.control.enabled = true;
+    overwrite(&ticks.proc0.control, [](auto& _) { _->enabled = false; });
+    overwrite(&ticks.proc0.cycles, [](auto& _) { _->count = 12; });
+    overwrite(&ticks.proc0.control, [](auto& _) { _->enabled = true; });
+    overwrite(&ticks.proc1.control, [](auto& _) { _->enabled = false; });
+    overwrite(&ticks.proc1.cycles, [](auto& _) { _->count = 12; });
+    overwrite(&ticks.proc1.control, [](auto& _) { _->enabled = true; });
 
     m33.rvr() = 1000;
-    m33.csr().enable = 1;
-    m33.csr().tickInt = 1;
+    update(&m33.csr(), [](auto& _) {
+        _->enable = 1;
+        _->tickInt = 1;
+    });
 }
 
 } // namespace rp2350::sys
@@ -235,9 +171,7 @@ struct [[gnu::packed]] [[gnu::aligned(4)]] Pixels {
     uint32_t const cmd_ = (2u << 12) | kHActive; // HSTX_CMD_TMDS
     Pixel pixels[kHActive];                      // packed RGB444 pixels follow
 
-    void clear(Pixel px = kDefault) {
-        for (auto i = 0u; i < kHActive; i++) { pixels[i] = px; }
-    }
+    void clear(Pixel px = kDefault) { fill16(pixels, px, kHActive); }
 
     Buffer buf() const {
         return {.words = (uint32_t const*)(this),
@@ -245,8 +179,14 @@ struct [[gnu::packed]] [[gnu::aligned(4)]] Pixels {
     }
 };
 
-auto& line0 = *(Pixels*)(0x20080000); // Even lines' pixels
-auto& line1 = *(Pixels*)(0x20081000); // Odd lines' pixels
+// Line buffers are pinned to the scratch banks, away from CPU traffic in striped SRAM
+Pixels& linePixels(Bank bank) {
+    auto* p = bankAlloc(bank, sizeof(Pixels));
+    if (!p) { __abort(); } // (the bank's section, e.g. a stack, has outgrown it)
+    return *(Pixels*)p;
+}
+auto& line0 = linePixels(Bank::SCRATCH_X); // Even lines
+auto& line1 = linePixels(Bank::SCRATCH_Y); // Odd lines
 
 unsigned nextLine = 0;
 unsigned thisFrame = 0;
@@ -290,7 +230,7 @@ void issueResets() {
     ;
     // clang-format on
 
-    resets.resets |= kMask;
+    atomicSet(&resets.resets, kMask);
     // Some components seem to need a little bit of time before un-reset.
     for (unsigned i = 0; i < 1000000; i++) { __nop(); }
 }
@@ -372,25 +312,15 @@ inline auto& busControl = *(BusControl*)(0x40068000);
 
 void initBusControl() { resets.unreset(Resets::Bit::BUSCTRL, true); }
 
-void configBusControl() { rp2350::busControl.priority.dmaRead = 1; }
+void configBusControl() {
+    atomicSet(&rp2350::busControl.priority, [](auto& _) { _->dmaRead = true; });
+}
 
 constexpr VBlankLine const vblankLine {};
 constexpr VSyncLine const vsyncLine {};
 
-void prepLine(unsigned line, Pixels& pxs) {
-    line += (thisFrame >> 4);
-    auto i = 176u;
-    Pixel px;
-    px.g = (line >> 4) & 0b1111;
-    px.r = line & 0b1111;
-    while (i < 688) {
-        px.b = ((i & 0b1110) >> 1) << 1;
-        pxs.pixels[i++] = px;
-        pxs.pixels[i++] = px;
-        ++px.b;
-        pxs.pixels[i++] = px;
-        pxs.pixels[i++] = px;
-    }
+[[gnu::section(".time_critical")]] void prepLine(unsigned line, Pixels& pxs) {
+    testPattern(line + (thisFrame >> 4), pxs.pixels, 176, kHActive);
 }
 
 void prepFrame(unsigned frame) { (void)frame; }
@@ -410,7 +340,8 @@ struct Entered final {
     auto enter() { return RAII {*this}; }
 };
 
-void tx() {
+// Line ISR; runs from SRAM (as does `prepLine`) for deterministic timing
+[[gnu::section(".time_critical")]] void tx() {
     static Entered entered;
     auto foo = entered.enter();
 
@@ -472,6 +403,10 @@ void tx() {
 }
 
 void setupDMAs() {
+    // Keep `dmaCopy` / `dmaFill` off the two channels feeding HSTX
+    claimDMAChannel(kDMAChannelA);
+    claimDMAChannel(kDMAChannelB);
+
     // Set up the two DMA channels; initially point them at dummy buffers (blank
     // lines).
     auto buf = vblankLine.buf();
@@ -504,9 +439,9 @@ void setupDMAs() {
 
     auto& irq = rp2350::dma.irqRegs(0);
     irq.status = (1u << kDMAChannelA) | (1u << kDMAChannelB); // clear flags
-    irq.enable = (1u << kDMAChannelA) | (1u << kDMAChannelB);
+    atomicSet(&irq.enable, (1u << kDMAChannelA) | (1u << kDMAChannelB));
 
-    sys::irqHandlers[kIRQDMA0] = tx;
+    setHandler(kIRQDMA0, tx); // (straight from the vector table; see `setHandler`)
     m33.clrPendIRQ(kIRQDMA0);
     m33.enableIRQ(kIRQDMA0);
 }
@@ -563,9 +498,9 @@ void setupDMAs() {
 
     auto& irq = rp2350::dma.irqRegs(0);
     irq.status = (1u << kDMAChannelA) | (1u << kDMAChannelB); // clear flags
-    irq.enable = (1u << kDMAChannelA) | (1u << kDMAChannelB);
+    atomicSet(&irq.enable, (1u << kDMAChannelA) | (1u << kDMAChannelB));
 
-    irqHandlers[kIRQDMA0] = tx;
+    setHandler(kIRQDMA0, tx);
     m33.clrPendIRQ(kIRQDMA0);
     m33.enableIRQ(kIRQDMA0);
 
@@ -0,0 +1,299 @@
+// Runs the library's init sequences, and a DMA copy, against the host-side peripheral
+// simulator (see `rp2350/sim.h`), printing how many register reads and writes each
+// step made.  Build and run with `make sim`; it exits non-zero if a checked step's
+// counts differ from those expected, or the copy comes out wrong.
+//
+// The expected counts are regression baselines: a change in them means an init
+// sequence now touches registers more (or less) than it did, which may be fine, but
+// should be looked at.  Plain (non-volatile) bitfield stores, as in `PLL::init`, are
+// up to the compiler to merge or split, so another compiler may need new baselines.
+
+#include <platform.h>
+#include <rp2350/dma.h>
+#include <rp2350/interrupts.h>
+#include <rp2350/m33.h>
+#include <rp2350/resets.h>
+#include <rp2350/sim.h>
+#include <rp2350/ticks.h>
+#include <rp2350/timer.h>
+#include <rp2350/timerwheel.h>
+#include <rp2350/uart.h>
+#include <rp2350/xoscpll.h>
+
+using namespace rp2350;
+
+unsigned failures;
+
+void report(char const* step) {
+    printf("\n== %s\n", step);
+    sim::sim.dump();
+    sim::sim.resetCounts();
+}
+
+struct Expected {
+    sim::Model const* model; // null for unmodelled accesses
+    uint32_t reads;
+    uint32_t writes;
+};
+
+// As above, but also check the counts: models listed in `expected` must have seen
+// exactly those, and all others nothing
+template <unsigned N> void report(char const* step, Expected const (&expected)[N]) {
+    auto counted = [&](sim::Model const* m, uint32_t reads, uint32_t writes) {
+        Expected want {m, 0, 0};
+        for (auto& e : expected) {
+            if (e.model == m) { want = e; }
+        }
+        if (reads == want.reads && writes == want.writes) { return; }
+        printf("!! %s: %s made %u reads, %u writes; expected %u, %u\n", step,
+               m ? m->name_ : "(unmodelled)", unsigned(reads), unsigned(writes),
+               unsigned(want.reads), unsigned(want.writes));
+        ++failures;
+    };
+    for (auto* m = sim::sim.models_; m; m = m->next_) {
+        counted(m, m->reads_, m->writes_);
+    }
+    counted(nullptr, sim::sim.otherReads_, sim::sim.otherWrites_);
+    report(step);
+}
+
+// Check that `n` bytes at `dst` match `src`, reporting the first difference
+void compare(char const* what, void const* dst, void const* src, size_t n) {
+    auto* d = (uint8_t const*)dst;
+    auto* s = (uint8_t const*)src;
+    for (size_t i = 0; i < n; i++) {
+        if (d[i] != s[i]) {
+            printf("!! %s: byte %u is %02x, expected %02x\n", what, unsigned(i), d[i],
+                   s[i]);
+            ++failures;
+            return;
+        }
+    }
+}
+
+uint32_t src[1024];
+uint32_t dst[1024];
+
+void check(bool ok, char const* what) {
+    if (!ok) {
+        printf("!! %s\n", what);
+        ++failures;
+    }
+}
+
+// `dmaCopy`, `dmaFill` and `DMAChain` at every source and destination alignment (mod
+// 4), against the expected bytes: the CPU doing small jobs and the head and tail
+// bytes, the DMA the rest in words or bytes, and every channel handed back after
+void dmaCases() {
+    auto* s = (uint8_t*)src;
+    auto* d = (uint8_t*)dst;
+    static uint8_t want[sizeof(dst)];
+    auto reset = [&] {
+        __aeabi_memset(d, sizeof(dst), 0xee);
+        __aeabi_memset(want, sizeof(want), 0xee);
+    };
+    auto dataSize = [](int ch) { return (sim::dmaModel.channels_[ch].ctrl >> 2) & 3; };
+
+    constexpr size_t kLengths[] {256, 257, 258, 259, 1000};
+    for (unsigned so = 0; so < 4; so++) {
+        for (unsigned dof = 0; dof < 4; dof++) {
+            for (auto n : kLengths) {
+                reset();
+                __aeabi_memcpy(want + 8 + dof, s + so, n);
+                auto job = dmaCopy(d + 8 + dof, s + so, n);
+                check(job.channel >= 0, "dmaCopy: large copy done by the CPU");
+                if (job.channel < 0) { continue; }
+                auto head = (4 - dof) & 3;
+                bool words = so == dof;
+                check(dataSize(job.channel) == (words ? 2u : 0u), "dmaCopy: data size");
+                check(sim::dmaModel.channels_[job.channel].reload ==
+                              (words ? (n - head) / 4 : n - head),
+                      "dmaCopy: transfer count");
+                job.wait();
+                compare("dmaCopy", d, want, sizeof(want));
+                check(!dmaClaimed, "dmaCopy: channel not released");
+            }
+        }
+    }
+
+    for (unsigned dof = 0; dof < 4; dof++) {
+        for (auto n : kLengths) {
+            reset();
+            __aeabi_memset(want + 8 + dof, n, 0x5a);
+            auto job = dmaFill(d + 8 + dof, 0x5a, n);
+            check(job.channel >= 0, "dmaFill: large fill done by the CPU");
+            job.wait();
+            compare("dmaFill", d, want, sizeof(want));
+            check(!dmaClaimed, "dmaFill: channel not released");
+        }
+    }
+
+    // Small copies, and copies with no channel free, are done by the CPU at once
+    sim::sim.resetCounts();
+    reset();
+    __aeabi_memcpy(want + 1, s, 255);
+    check(dmaCopy(d + 1, s, 255).channel < 0, "dmaCopy: small copy given to the DMA");
+    compare("dmaCopy (small)", d, want, sizeof(want));
+    dmaClaimed = 0xffff;
+    __aeabi_memcpy(want + 1, s + 2, 2000);
+    check(dmaCopy(d + 1, s + 2, 2000).channel < 0, "dmaCopy: no channel, yet DMA");
+    compare("dmaCopy (no channel)", d, want, sizeof(want));
+    dmaClaimed = 0;
+    check(!sim::dmaModel.reads_ && !sim::dmaModel.writes_, "dmaCopy: CPU used DMA");
+
+    // A chain: the first piece runs on `start`, the rest as each one before finishes
+    reset();
+    __aeabi_memcpy(want, s, 512);
+    __aeabi_memset(want + 600, 300, 0x11);
+    __aeabi_memcpy(want + 1000, s + 3, 100);
+    __aeabi_memcpy(want + 1201, s + 1, 1500);
+    DMAChain chain;
+    chain.copy(d, s, 512);
+    chain.fill(d + 600, 0x11, 300);
+    chain.copy(d + 1000, s + 3, 100); // (small: done by the CPU, here and now)
+    chain.copy(d + 1201, s + 1, 1500);
+    check(dmaClaimed == 7, "DMAChain: channels claimed"); // (lowest free first)
+    auto job = chain.start();
+    check(job.channel >= 0 && job.chained, "DMAChain: not chained");
+    unsigned steps = 0;
+    for (; !job.done() && steps < 10; steps++) { sim::sim.idle(); }
+    check(steps == 2, "DMAChain: pieces didn't follow one another");
+    compare("DMAChain", d, want, sizeof(want));
+    check(!dmaClaimed, "DMAChain: channels not released");
+}
+
+constinit TimerWheel wheel {0, 0};
+unsigned ticksSeen;
+SoftTimer tickTimer {[](SoftTimer&) { ++ticksSeen; }, nullptr, 250};
+SoftTimer stopTimer {[](SoftTimer&) { wheel.cancel(tickTimer); }};
+
+// A timer for `wheelCases`, noting when (and how often) it fires
+struct Probe {
+    SoftTimer timer;
+    uint64_t due;
+    uint64_t addedAt;
+    uint64_t firedAt;
+    unsigned fired;
+    bool cancelled;
+};
+
+Probe probes[64];
+
+// `TimerWheel` against the simulated TIMER0: one-shot timers spread over the first
+// level-0 slot to a few hours ahead (past the far list's 2^30us, and past the alarm's
+// 32-bit compare), some cancelled before they're due.  Each timer not cancelled must
+// fire exactly once, never before its deadline and only a few microseconds after it;
+// the cancelled ones never.  (The simulated clock moves on 1us per read of it.)
+void wheelCases() {
+    constexpr static uint64_t kLate = 16; // us; more is a missed or misplaced slot
+    auto base = timer0.now();
+    uint32_t seed = 12345;
+    auto next = [&] { return seed = seed * 1664525 + 1013904223; };
+    for (unsigned i = 0; i < 64; i++) {
+        auto& p = probes[i];
+        p.timer = SoftTimer {[](SoftTimer& t) {
+                                 auto* p = t.ctx<Probe>();
+                                 p->firedAt = timer0.now();
+                                 ++p->fired;
+                             },
+                             &p};
+        p.due = i < 4    ? base - i                          // (already passed)
+                : i < 48 ? base + next() % 200000            // within the wheel
+                : i < 56 ? base + (1u << 30) + next() % 5000 // on the far list
+                         : base + (uint64_t(1) << 33) + next() % 5000;
+        p.addedAt = timer0.now();
+        wheel.add(p.timer, p.due);
+        if (i % 5 == 3) {
+            wheel.cancel(p.timer);
+            p.cancelled = true;
+        }
+    }
+
+    // Partway through, cancel some more of those still waiting
+    auto pending = [] {
+        for (auto& p : probes) {
+            if (p.timer.pending()) { return true; }
+        }
+        return false;
+    };
+    while (timer0.now() < base + 100000) { __wfi(); }
+    for (unsigned i = 0; i < 64; i += 7) {
+        if (probes[i].timer.pending()) {
+            wheel.cancel(probes[i].timer);
+            probes[i].cancelled = true;
+        }
+    }
+    for (unsigned steps = 0; pending() && steps < 100000; steps++) { __wfi(); }
+
+    uint64_t worst = 0;
+    for (auto& p : probes) {
+        if (p.cancelled) {
+            check(!p.fired, "TimerWheel: a cancelled timer fired");
+            continue;
+        }
+        check(p.fired == 1, "TimerWheel: a timer didn't fire exactly once");
+        check(p.firedAt >= p.due, "TimerWheel: a timer fired early");
+        // (Those already due when added fire on the IRQ pended by `add`, which the
+        // simulator takes only at the next `__wfi`: no deadline to be late for)
+        if (p.due > p.addedAt && p.firedAt - p.due > worst) {
+            worst = p.firedAt - p.due;
+        }
+    }
+    check(worst <= kLate, "TimerWheel: a timer fired late");
+    check(wheel.cascaded_ > 0, "TimerWheel: nothing cascaded");
+    printf("\nlatest firing %u us after its deadline\n", unsigned(worst));
+}
+
+int main() {
+    sim::sim.start();
+
+    initResets();
+    report("initResets", {{&sim::resetsModel, 1, 1}});
+
+    xosc.init();
+    sysPLL.init();
+    report("xosc.init, sysPLL.init", {
+        {&sim::xoscModel, 3, 6},
+        {&sim::sysPLLModel, 4, 7},
+        {&sim::resetsModel, 2, 0},
+    });
+
+    initCPUBasic();
+    initSystemTicks();
+    report("initCPUBasic, initSystemTicks");
+
+    resets.unreset(Resets::Bit::UART0);
+    uart0.init(kSysHz, 115200);
+    report("uart0.init");
+
+    initTimers();
+    auto t0 = timer0.now();
+    timer0.sleepFor(1000);
+    printf("\nslept %u us\n", unsigned(timer0.now() - t0));
+    report("initTimers, sleepFor(1000)");
+
+    irqHandlers[wheel.irqn()] = [] { wheel.onAlarm(); };
+    __enableIRQs();
+    wheel.start();
+    wheel.addIn(tickTimer, 250);
+    wheel.addIn(stopTimer, 1100);
+    for (unsigned steps = 0; tickTimer.pending() && steps < 1000; steps++) { __wfi(); }
+    check(!tickTimer.pending(), "TimerWheel: periodic timer not cancelled");
+    printf("\n%u ticks, %u callbacks\n", ticksSeen, unsigned(wheel.fired_));
+    report("TimerWheel: 250us periodic, cancelled at 1100us");
+
+    wheelCases();
+    report("TimerWheel: one-shots, near and far, some cancelled");
+
+    initDMA();
+    for (unsigned i = 0; i < 1024; i++) { src[i] = i * 0x01010101u; }
+    dmaCopy(dst, src, sizeof(src)).wait();
+    compare("dmaCopy (4kB)", dst, src, sizeof(src));
+    report("dmaCopy (4kB)", {{&sim::dmaModel, 1, 5}, {&sim::resetsModel, 2, 1}});
+
+    dmaCases();
+    report("dmaCopy, dmaFill, DMAChain: alignments, CPU fallbacks, chaining");
+
+    printf("\n%s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
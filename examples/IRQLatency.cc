@@ -0,0 +1,110 @@
+// Interrupt latency, in cycles from pending an IRQ (a write to NVIC ISPR) to the first
+// instruction of its handler's body, three ways:
+//
+//   - "trampoline": the default vector, `irq`, calling the handler via `irqHandlers`
+//   - "setHandler": the handler set directly in the SRAM vector table at run time
+//   - "withIRQ": the handler placed in a vector table built at compile time
+//
+// The last two should agree, and both come in under the first by the trampoline's
+// IPSR read, range check and indirect call.  Each is measured a few thousand times on
+// one of the spare IRQs, which no peripheral raises; the figures are printed on UART0
+// every second, after the cycles `__reset` took at boot.  Build with
+// `make EXAMPLE=IRQLatency`.
+
+#include <platform.h>
+#include <rp2350/clocks.h>
+#include <rp2350/common.h>
+#include <rp2350/cycles.h>
+#include <rp2350/gpio.h>
+#include <rp2350/insns.h>
+#include <rp2350/interrupts.h>
+#include <rp2350/m33.h>
+#include <rp2350/pads.h>
+#include <rp2350/panic.h>
+#include <rp2350/reset.h>
+#include <rp2350/resets.h>
+#include <rp2350/uart.h>
+#include <rp2350/xoscpll.h>
+
+namespace rp2350::sys {
+
+[[gnu::retain]] [[gnu::used]] [[gnu::section(
+    ".vec_table")]] ARMVectors const gARMVectors;
+
+[[gnu::retain]] [[gnu::used]] [[gnu::section(
+    ".image_def")]] constinit ImageDef2350ARM const gImageDef;
+
+} // namespace rp2350::sys
+
+using namespace rp2350;
+
+constexpr static unsigned kIRQTrampoline = 46; // p.84: SPARE_IRQ_0
+constexpr static unsigned kIRQDirect = 47;     // SPARE_IRQ_1
+constexpr static unsigned kIRQStatic = 48;     // SPARE_IRQ_2
+constexpr static unsigned kRounds = 4096;
+
+constinit CycleCounter gTrampoline {"trampoline"};
+constinit CycleCounter gDirect {"setHandler"};
+constinit CycleCounter gStatic {"withIRQ"};
+
+uint32_t gPendedAt; // cycle count just before pending the IRQ
+
+[[gnu::always_inline]] inline uint32_t sincePended() {
+    return m33.cycles() - __atomic_load_n(&gPendedAt, __ATOMIC_RELAXED);
+}
+
+[[gnu::section(".time_critical")]] void trampolineIRQ() {
+    gTrampoline.add(sincePended());
+}
+
+[[gnu::section(".time_critical")]] void directIRQ() { gDirect.add(sincePended()); }
+
+[[gnu::section(".time_critical")]] void staticIRQ() { gStatic.add(sincePended()); }
+
+// Like `__vectorTable`, but with `staticIRQ` in place from the start
+[[gnu::retain]] [[gnu::used]] [[gnu::section(".sysdata")]]
+constinit ARMVectors gVectors = ARMVectors {}.withIRQ(kIRQStatic, staticIRQ);
+
+void measure(unsigned irq) {
+    m33.clrPendIRQ(irq);
+    m33.enableIRQ(irq);
+    for (unsigned i = 0; i < kRounds; i++) {
+        __atomic_store_n(&gPendedAt, m33.cycles(), __ATOMIC_RELAXED);
+        m33.triggerIRQ(irq);
+        __dsb(); // (taken by here)
+        __isb();
+    }
+    m33.disableIRQ(irq);
+}
+
+[[gnu::retain]] [[gnu::used]] [[gnu::noreturn]] [[gnu::noinline]] void __start() {
+    initSystemClock();
+    initRefClock();
+    initPeriphClock();
+    initCPUBasic();
+    // (No SysTick, which would land in the middle of some measurements)
+
+    useVectors(gVectors);
+    initInterrupts();
+
+    resets.unreset(Resets::Bit::PADSBANK0);
+    resets.unreset(Resets::Bit::IOBANK0);
+    initOutput<0>(GPIO::FuncSel<0>::UART0TX);
+    initInput<1>(GPIO::FuncSel<1>::UART0RX);
+    resets.unreset(Resets::Bit::UART0);
+    uart0.init(kSysHz, 115200);
+    dumpBootTimes([](char const* s) { uart0.write(s); }); // (once: `__reset`'s phases)
+
+    irqHandlers[kIRQTrampoline] = trampolineIRQ;
+    setHandler(kIRQDirect, directIRQ);
+
+    while (true) {
+        resetCycleCounters();
+        measure(kIRQTrampoline);
+        measure(kIRQDirect);
+        measure(kIRQStatic);
+        uart0.write("IRQ entry latency, cycles:\n");
+        dumpCycles([](char const* s) { uart0.write(s); });
+        for (unsigned i = 0; i < kSysHz / 4; i++) { __nop(); }
+    }
+}
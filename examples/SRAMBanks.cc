@@ -0,0 +1,136 @@
+// Bus contention between the CPU and the DMA, with the DMA's buffers striped or
+// bank-pinned.  The CPU sums a buffer in main SRAM (SRAM0-3, striped word by word)
+// while the DMA copies 1kB, two ways:
+//
+//   - "striped": between two more buffers in main SRAM, so both masters take turns
+//     at the same four banks
+//   - "pinned": from SCRATCH_X to SCRATCH_Y (`bankAlloc`), which the CPU's loop
+//     doesn't touch
+//
+// For each, the bus performance counters give all accesses and contested ones (those
+// stalled by the other master) summed over the ten SRAM bank ports, and the DWT the
+// CPU loop's cycles.  Pinned should show next to no contention and the CPU loop at its
+// uncontended speed.  The figures are printed on UART0 every second.  Build with
+// `make EXAMPLE=SRAMBanks`.
+
+#include <format.h>
+#include <platform.h>
+#include <rp2350/buscontrol.h>
+#include <rp2350/clocks.h>
+#include <rp2350/common.h>
+#include <rp2350/cycles.h>
+#include <rp2350/dma.h>
+#include <rp2350/gpio.h>
+#include <rp2350/insns.h>
+#include <rp2350/interrupts.h>
+#include <rp2350/m33.h>
+#include <rp2350/pads.h>
+#include <rp2350/panic.h>
+#include <rp2350/resets.h>
+#include <rp2350/sram.h>
+#include <rp2350/uart.h>
+#include <rp2350/xoscpll.h>
+
+namespace rp2350::sys {
+
+[[gnu::retain]] [[gnu::used]] [[gnu::section(
+    ".vec_table")]] ARMVectors const gARMVectors;
+
+[[gnu::retain]] [[gnu::used]] [[gnu::section(
+    ".image_def")]] constinit ImageDef2350ARM const gImageDef;
+
+} // namespace rp2350::sys
+
+using namespace rp2350;
+
+constexpr static unsigned kWords = 256; // 1kB, leaving room for e.g. core 1's stack
+constexpr static unsigned kBanks = 10;  // SRAM0-9
+
+uint32_t cpuData[kWords];
+uint32_t stripedSrc[kWords];
+uint32_t stripedDst[kWords];
+uint32_t gSum; // (so the CPU loop isn't optimized away)
+
+constinit CycleCounter gStriped {"striped"};
+constinit CycleCounter gPinned {"pinned"};
+
+struct Counts {
+    uint32_t accesses;
+    uint32_t contested;
+};
+
+// Run the CPU loop alongside a DMA copy from `src` to `dst`, once per SRAM bank,
+// counting that bank's accesses each time (two counters per bank, of four)
+Counts measure(CycleCounter& cpu, uint32_t* dst, uint32_t const* src) {
+    Counts counts {};
+    for (unsigned bank = 0; bank < kBanks; bank++) {
+        busControl.perfSelect(0, sramPort(bank), BusControl::Event::ACCESS);
+        busControl.perfSelect(1, sramPort(bank), BusControl::Event::ACCESS_CONTESTED);
+        auto job = dmaCopy(dst, src, kWords * 4);
+        {
+            ScopedCycles _ {cpu};
+            auto* p = (uint32_t const volatile*)cpuData;
+            uint32_t sum = 0;
+            for (unsigned i = 0; i < kWords; i++) { sum += p[i]; }
+            gSum = sum;
+        }
+        job.wait();
+        counts.accesses += busControl.perfRead(0);
+        counts.contested += busControl.perfRead(1);
+    }
+    return counts;
+}
+
+// e.g. "striped         accesses=5130 contested=412"
+void print(char const* name, Counts counts) {
+    char line[64];
+    auto* p = line;
+    auto append = [&](char const* s) {
+        while (*s) { *p++ = *s++; }
+    };
+    append(name);
+    while (p < line + 16) { *p++ = ' '; }
+    append("accesses=");
+    p = formatDec(p, counts.accesses);
+    append(" contested=");
+    p = formatDec(p, counts.contested);
+    *p++ = '\n';
+    *p = 0;
+    uart0.write((char const*)line);
+}
+
+[[gnu::retain]] [[gnu::used]] [[gnu::noreturn]] [[gnu::noinline]] void __start() {
+    initSystemClock();
+    initRefClock();
+    initPeriphClock();
+    initCPUBasic();
+
+    resets.unreset(Resets::Bit::PADSBANK0);
+    resets.unreset(Resets::Bit::IOBANK0);
+    initOutput<0>(GPIO::FuncSel<0>::UART0TX);
+    initInput<1>(GPIO::FuncSel<1>::UART0RX);
+    resets.unreset(Resets::Bit::UART0);
+    uart0.init(kSysHz, 115200);
+
+    initBusControl();
+    initDMA();
+
+    auto* pinnedSrc = (uint32_t*)bankAlloc(Bank::SCRATCH_X, kWords * 4);
+    auto* pinnedDst = (uint32_t*)bankAlloc(Bank::SCRATCH_Y, kWords * 4);
+    if (!pinnedSrc || !pinnedDst) { __abort(); }
+    for (unsigned i = 0; i < kWords; i++) {
+        cpuData[i] = stripedSrc[i] = pinnedSrc[i] = i;
+    }
+
+    while (true) {
+        resetCycleCounters();
+        auto striped = measure(gStriped, stripedDst, stripedSrc);
+        auto pinned = measure(gPinned, pinnedDst, pinnedSrc);
+        uart0.write("SRAM bank accesses during a 1kB DMA copy:\n");
+        print("striped", striped);
+        print("pinned", pinned);
+        uart0.write("CPU loop, cycles:\n");
+        dumpCycles([](char const* s) { uart0.write(s); });
+        for (unsigned i = 0; i < kSysHz / 4; i++) { __nop(); }
+    }
+}
@@ -0,0 +1,100 @@
+// Coroutine tasks (see `rp2350/task.h`) in place of busy loops and ISR state machines:
+// one task blinks the LED, one echoes UART0 input a line at a time, and one
+// periodically copies a buffer by DMA.  Between events the core sleeps in WFI.
+// Build with `make EXAMPLE=Tasks`.
+
+#include <platform.h>
+#include <rp2350/clocks.h>
+#include <rp2350/common.h>
+#include <rp2350/dma.h>
+#include <rp2350/gpio.h>
+#include <rp2350/interrupts.h>
+#include <rp2350/m33.h>
+#include <rp2350/pads.h>
+#include <rp2350/panic.h>
+#include <rp2350/resets.h>
+#include <rp2350/task.h>
+#include <rp2350/taskio.h>
+#include <rp2350/timer.h>
+#include <rp2350/timerwheel.h>
+#include <rp2350/uart.h>
+#include <rp2350/xoscpll.h>
+
+namespace rp2350::sys {
+
+[[gnu::retain]] [[gnu::used]] [[gnu::section(
+    ".vec_table")]] ARMVectors const gARMVectors;
+
+[[gnu::retain]] [[gnu::used]] [[gnu::section(
+    ".image_def")]] constinit ImageDef2350ARM const gImageDef;
+
+} // namespace rp2350::sys
+
+using namespace rp2350;
+
+constinit TimerWheel gWheel {0, 0}; // TIMER0, alarm 0
+
+Task blink() {
+    while (true) {
+        sio.gpioOutXor = 1 << 25;
+        co_await sleepFor(gWheel, 250'000);
+    }
+}
+
+Task echo() {
+    char line[64];
+    unsigned n = 0;
+    while (true) {
+        char c = co_await uartRead(uart0);
+        if (c != '\r' && n < sizeof(line) - 1) {
+            line[n++] = c;
+            continue;
+        }
+        line[n] = 0;
+        uart0.write(line);
+        uart0.write("\n");
+        n = 0;
+    }
+}
+
+uint32_t src[1024];
+uint32_t dst[1024];
+
+Task copier() {
+    for (uint32_t round = 0;; ++round) {
+        for (unsigned i = 0; i < 1024; i++) { src[i] = round + i; }
+        auto job = dmaCopy(dst, src, sizeof(src));
+        co_await dmaDone(job);
+        if (dst[1023] != round + 1023) { uart0.write("copier: mismatch\n"); }
+        co_await sleepFor(gWheel, 1'000'000);
+    }
+}
+
+[[gnu::retain]] [[gnu::used]] [[gnu::noreturn]] [[gnu::noinline]] void __start() {
+    initInterrupts();
+    initSystemClock();
+    initRefClock();
+    initPeriphClock();
+    initCPUBasic();
+    // (No SysTick: it would only wake the core every millisecond)
+
+    resets.unreset(Resets::Bit::PADSBANK0);
+    resets.unreset(Resets::Bit::IOBANK0);
+    initOutput<25>();
+    initOutput<0>(GPIO::FuncSel<0>::UART0TX);
+    initInput<1>(GPIO::FuncSel<1>::UART0RX);
+    resets.unreset(Resets::Bit::UART0);
+    uart0.init(kSysHz, 115200);
+
+    initTimers();
+    irqHandlers[gWheel.irqn()] = [] { gWheel.onAlarm(); };
+    gWheel.start();
+    initUARTRead(uart0);
+    initDMA();
+    initDMADone();
+
+    executor.spawn(blink());
+    executor.spawn(echo());
+    executor.spawn(copier());
+    executor.run();
+}
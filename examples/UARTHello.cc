@@ -1,4 +1,5 @@
 #include <platform.h>
+#include <ring.h>
 #include <rp2350/clocks.h>
 #include <rp2350/common.h>
 #include <rp2350/gpio.h>
@@ -31,35 +32,16 @@ namespace rp2350::sys {
 
 using namespace rp2350;
 
-template <uint16_t N> struct Buffer {
-    uint16_t head {0}; // next read / pop / dequeue pos
-    uint16_t tail {0}; // next write / push / enqueue pos
-    uint8_t buf[N];
-
-    size_t size() const { return (tail - head) % N; }
-    bool empty() const { return head == tail; }
-    bool full() const { return size() == N - 1; }
-
-    void push(uint8_t x) {
-        while (full()) { sys::debug() << "push:full"; }
-        buf[tail] = x;
-        tail = (tail + 1) % N;
-    }
-
-    uint8_t pop() {
-        uint8_t ret = 0xff;
-        while (empty()) { sys::debug() << "pop:empty"; }
-        ret = buf[head];
-        head = (head + 1) % N;
-        return ret;
-    }
-};
-
-Buffer<64> txBuffer;
-Buffer<64> rxBuffer;
+// Filled by thread code and drained by the UART ISR (and vice versa for RX)
+SpscRing<uint8_t, 64> txBuffer;
+SpscRing<uint8_t, 64> rxBuffer;
 
 void putC(char c) {
-    txBuffer.push(c);
+    // If it's full, the ISR will make room as the UART's TX FIFO drains.  Wait for
+    // that before pushing, so this back-pressure isn't counted as an overflow; once
+    // there's room it stays, as only we add to it.
+    while (txBuffer.full()) { rp2350::__wfi(); }
+    txBuffer.push(uint8_t(c));
     m33.triggerIRQ(uart0.irqn());
 }
 
@@ -83,10 +65,10 @@ void putS(char const* s) {
 }
 
 void uart0IRQ() {
-    while (!uart0.flags.rxEmpty && !rxBuffer.full()) { rxBuffer.push(uart0.data.data); }
-    while (!uart0.flags.txFull && !txBuffer.empty()) {
-        uart0.data.data = txBuffer.pop();
-    }
+    // (Input arriving with `rxBuffer` full is dropped, and counted in its `overflows_`)
+    while (!uart0.flags.rxEmpty) { rxBuffer.push(uint8_t(uart0.data.data)); }
+    uint8_t c;
+    while (!uart0.flags.txFull && txBuffer.pop(c)) { uart0.data.data = c; }
     uart0.intClear.u32() = 0x7ff;
 }
 
@@ -105,19 +87,24 @@ void uart0IRQ() {
 
     // p569: SDK expects nominal 1uS system ticks, as does Arm internals.
     // Although we don't use the SDK we'll assume 1uS everywhere as well.
-    ticks.proc0.control.enabled = false; // disable while configuring
-    ticks.proc0.cycles.count = 12;
-    ticks.proc0.control.enabled = true;
-    ticks.proc1.control.enabled = false; // disable while configuring
-    ticks.proc1.cycles.count = 12;
-    ticks.proc1.control.enabled = true;
-
-    m33.ccr().unalignedTrap = true;
-    m33.ccr().div0Trap = true;
+    // (Disable each while configuring it)
+    overwrite(&ticks.proc0.control, [](auto& _) { _->enabled = false; });
+    overwrite(&ticks.proc0.cycles, [](auto& _) { _->count = 12; });
+    overwrite(&ticks.proc0.control, [](auto& _) { _->enabled = true; });
+    overwrite(&ticks.proc1.control, [](auto& _) { _->enabled = false; });
+    overwrite(&ticks.proc1.cycles, [](auto& _) { _->count = 12; });
+    overwrite(&ticks.proc1.control, [](auto& _) { _->enabled = true; });
+
+    update(&m33.ccr(), [](auto& _) {
+        _->unalignedTrap = true;
+        _->div0Trap = true;
+    });
 
     m33.rvr() = 1000;
-    m33.csr().enable = 1;
-    m33.csr().tickInt = 1;
+    update(&m33.csr(), [](auto& _) {
+        _->enable = 1;
+        _->tickInt = 1;
+    });
 
     resets.unreset(Resets::Bit::PADSBANK0);
     resets.unreset(Resets::Bit::IOBANK0);
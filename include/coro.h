@@ -0,0 +1,73 @@
+#pragma once
+
+#include <platform.h>
+
+// The parts of `<coroutine>` which the compiler's coroutine lowering looks up in
+// `std`, as we build without a standard library (`-nostdinc`).  Host builds use the
+// real header, in case anything else there includes it too.
+
+#if defined(RP2350_HOST) && __has_include(<coroutine>)
+
+#include <coroutine>
+
+#else
+
+namespace std {
+
+template <class R, class... A> struct coroutine_traits {
+    using promise_type = typename R::promise_type;
+};
+
+template <class P = void> struct coroutine_handle;
+
+template <> struct coroutine_handle<void> {
+    void* frame_ {};
+
+    constexpr coroutine_handle() = default;
+    constexpr coroutine_handle(decltype(nullptr)) {}
+
+    static coroutine_handle from_address(void* frame) {
+        coroutine_handle h;
+        h.frame_ = frame;
+        return h;
+    }
+
+    void* address() const { return frame_; }
+    explicit operator bool() const { return frame_; }
+    bool done() const { return __builtin_coro_done(frame_); }
+    void resume() const { __builtin_coro_resume(frame_); }
+    void destroy() const { __builtin_coro_destroy(frame_); }
+    void operator()() const { resume(); }
+};
+
+template <class P> struct coroutine_handle : coroutine_handle<> {
+    static coroutine_handle from_address(void* frame) {
+        coroutine_handle h;
+        h.frame_ = frame;
+        return h;
+    }
+
+    static coroutine_handle from_promise(P& promise) {
+        return from_address(__builtin_coro_promise(&promise, alignof(P), true));
+    }
+
+    P& promise() const {
+        return *(P*)__builtin_coro_promise(frame_, alignof(P), false);
+    }
+};
+
+struct suspend_always {
+    constexpr bool await_ready() const noexcept { return false; }
+    constexpr void await_suspend(coroutine_handle<>) const noexcept {}
+    constexpr void await_resume() const noexcept {}
+};
+
+struct suspend_never {
+    constexpr bool await_ready() const noexcept { return true; }
+    constexpr void await_suspend(coroutine_handle<>) const noexcept {}
+    constexpr void await_resume() const noexcept {}
+};
+
+} // namespace std
+
+#endif
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <platform.h>
+
+namespace rp2350 {
+
+// Number formatting into caller-provided buffers; no allocation, no terminator
+// written.  Each returns a pointer just past the last character written.
+
+// The low `nibs` (at most 8) hex digits of `x`, most significant first.
+inline char* formatHex(char* out, uint32_t x, unsigned nibs = 8) {
+    constexpr static char const* kHex = "0123456789abcdef";
+    for (auto shift = nibs << 2; shift; shift -= 4) {
+        *out++ = kHex[(x >> (shift - 4)) & 0x0f];
+    }
+    return out;
+}
+
+// Decimal digits of `x`, without leading zeros (so at most 10 characters).
+inline char* formatDec(char* out, uint32_t x) {
+    char digits[10];
+    unsigned n = 0;
+    do {
+        digits[n++] = char('0' + (x % 10));
+        x /= 10;
+    } while (x);
+    while (n) { *out++ = digits[--n]; }
+    return out;
+}
+
+// As above, for 64-bit values (at most 20 characters).  Digits are found by
+// subtracting powers of ten, as the M33 has no 64-bit divide (and we have no runtime
+// helper for one).
+inline char* formatDec(char* out, uint64_t x) {
+    if (!(x >> 32)) { return formatDec(out, uint32_t(x)); }
+    constexpr static uint64_t kPowers[] {
+        10'000'000'000'000'000'000ull, 1'000'000'000'000'000'000ull,
+        100'000'000'000'000'000ull,    10'000'000'000'000'000ull,
+        1'000'000'000'000'000ull,      100'000'000'000'000ull,
+        10'000'000'000'000ull,         1'000'000'000'000ull,
+        100'000'000'000ull,            10'000'000'000ull,
+        1'000'000'000ull,              100'000'000ull,
+        10'000'000ull,                 1'000'000ull,
+        100'000ull,                    10'000ull,
+        1'000ull,                      100ull,
+        10ull,                         1ull,
+    };
+    auto const* power = kPowers;
+    while (*power > x) { ++power; }
+    for (; power < kPowers + 20; ++power) {
+        char digit = '0';
+        while (x >= *power) {
+            x -= *power;
+            ++digit;
+        }
+        *out++ = digit;
+    }
+    return out;
+}
+
+// As above, with a leading '-' if negative (at most 11 characters).
+inline char* formatDec(char* out, int32_t x) {
+    if (x < 0) {
+        *out++ = '-';
+        return formatDec(out, uint32_t(0) - uint32_t(x));
+    }
+    return formatDec(out, uint32_t(x));
+}
+
+} // namespace rp2350
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <platform.h>
+
+extern "C" {
+
+// Defined in the linker script
+extern void* __heap;
+extern void* __heap_end;
+
+} // extern "C"
+
+namespace rp2350 {
+
+// General-purpose allocator over one contiguous range of memory; the global `heap`
+// below manages `__heap` through `__heap_end` (the end of SRAM0-3, see `layout.ld`).
+//
+// Every block starts with an 8-byte header holding the size of the block physically
+// before it (for coalescing backwards) and its own size, whose low bits carry flags.
+//
+// Requests up to `kSmallMax` bytes are rounded up to one of `kClasses` size classes,
+// each with its own free list; these are pushed and popped in O(1) and never merged.
+// Larger blocks are taken first-fit from a doubly-linked free list, split if there's
+// enough left over, and coalesced with free neighbours when freed.  Either kind is
+// carved off the untouched "top" of the heap when its free list comes up empty, and
+// large blocks adjacent to the top are given back to it.
+//
+// This is not interrupt-safe: allocate from thread context only.
+struct Heap {
+    constexpr static size_t kAlign = 8;
+    constexpr static size_t kHeader = 8;
+    constexpr static size_t kSmallMax = 256;
+    constexpr static unsigned kClasses = kSmallMax / kAlign;
+
+    struct Stats {
+        size_t inUse;       // bytes in allocated blocks (including headers)
+        size_t peak;        // high-water mark of `inUse`
+        size_t free;        // bytes in free lists, plus the untouched top
+        size_t largestFree; // largest single free block (or the top)
+        uint32_t allocs;
+        uint32_t frees;
+        uint32_t failures;
+
+        // Percentage of free memory which is *not* in the largest free block;
+        // 0 means that all free memory is in one piece.
+        unsigned fragmentation() const {
+            return free ? unsigned(100 - (uint64_t(largestFree) * 100) / free) : 0;
+        }
+    };
+
+    struct Block {
+        constexpr static uint32_t kUsed = 1;  // allocated, or parked in a small list
+        constexpr static uint32_t kSmall = 2; // exactly one size class's size
+        constexpr static uint32_t kFlags = kUsed | kSmall;
+
+        uint32_t prevSize; // size of the block before this one (0 if first)
+        uint32_t sizeBits; // size of this block, header included; plus flags
+
+        // These overlay the payload, and are only valid while the block is free
+        Block* next;
+        Block* prev;
+
+        size_t size() const { return sizeBits & ~kFlags; }
+        bool used() const { return sizeBits & kUsed; }
+        bool small() const { return sizeBits & kSmall; }
+        void* payload() { return (uint8_t*)this + kHeader; }
+        Block* after() { return (Block*)((uint8_t*)this + size()); }
+        Block* before() { return (Block*)((uint8_t*)this - prevSize); }
+        static Block* of(void* p) { return (Block*)((uint8_t*)p - kHeader); }
+    };
+
+    constexpr static size_t kMinBlock = (sizeof(Block) + kAlign - 1) & ~(kAlign - 1);
+
+    uint8_t* begin_ {};
+    uint8_t* top_ {};
+    uint8_t* end_ {};
+    uint32_t topPrevSize_ {}; // size of the block just below `top_`
+    Block* small_[kClasses] {};
+    Block* large_ {};
+    size_t inUse_ {};
+    size_t peak_ {};
+    uint32_t allocs_ {};
+    uint32_t frees_ {};
+    uint32_t failures_ {};
+
+    constexpr Heap() = default;
+    Heap(void* begin, void* end) { init(begin, end); }
+
+    bool ready() const { return begin_; }
+
+    void init(void* begin, void* end) {
+        *this = Heap();
+        begin_ = (uint8_t*)((uintptr_t(begin) + kAlign - 1) & ~(kAlign - 1));
+        end_ = (uint8_t*)(uintptr_t(end) & ~(kAlign - 1));
+        top_ = begin_;
+    }
+
+    void* alloc(size_t n) {
+        Block* b;
+        if (n <= kSmallMax) {
+            auto cls = unsigned(n ? (n - 1) / kAlign : 0);
+            auto size = kHeader + (cls + 1) * kAlign;
+            if ((b = small_[cls])) {
+                small_[cls] = b->next;
+            } else if ((b = carve(size))) {
+                b->sizeBits |= Block::kSmall;
+            } else {
+                b = takeLarge(size);
+            }
+        } else {
+            auto size = (n + kHeader + kAlign - 1) & ~(kAlign - 1);
+            if (size < n) { size = ~size_t(0); } // (overflowed)
+            if (!(b = takeLarge(size))) { b = carve(size); }
+        }
+        if (!b) {
+            ++failures_;
+            return nullptr;
+        }
+        b->sizeBits |= Block::kUsed;
+        ++allocs_;
+        inUse_ += b->size();
+        if (inUse_ > peak_) { peak_ = inUse_; }
+        return b->payload();
+    }
+
+    void free(void* p) {
+        if (!p) { return; }
+        auto* b = Block::of(p);
+        ++frees_;
+        inUse_ -= b->size();
+
+        if (b->small()) {
+            auto cls = unsigned((b->size() - kHeader) / kAlign - 1);
+            b->next = small_[cls];
+            small_[cls] = b;
+            return;
+        }
+
+        b->sizeBits &= ~Block::kUsed;
+        auto* next = b->after();
+        if ((uint8_t*)next < top_ && !next->used()) {
+            unlink(next);
+            b->sizeBits += next->size();
+        }
+        if ((uint8_t*)b > begin_ && !b->before()->used()) {
+            auto* prev = b->before();
+            unlink(prev);
+            prev->sizeBits += b->size();
+            b = prev;
+        }
+
+        if ((uint8_t*)b->after() == top_) {
+            // Last block before the top: just lower the top
+            top_ = (uint8_t*)b;
+            topPrevSize_ = b->prevSize;
+            return;
+        }
+        b->after()->prevSize = uint32_t(b->size());
+        link(b);
+    }
+
+    // Usable size of an allocated block (may be more than was asked for)
+    static size_t usable(void* p) { return Block::of(p)->size() - kHeader; }
+
+    Stats stats() const {
+        Stats ret {.inUse = inUse_,
+                   .peak = peak_,
+                   .free = size_t(end_ - top_),
+                   .largestFree = size_t(end_ - top_),
+                   .allocs = allocs_,
+                   .frees = frees_,
+                   .failures = failures_};
+        for (auto* b = large_; b; b = b->next) {
+            ret.free += b->size();
+            if (b->size() > ret.largestFree) { ret.largestFree = b->size(); }
+        }
+        for (auto* b : small_) {
+            for (; b; b = b->next) { ret.free += b->size(); }
+        }
+        return ret;
+    }
+
+private:
+    Block* carve(size_t size) {
+        if (size > size_t(end_ - top_)) { return nullptr; }
+        auto* b = (Block*)top_;
+        b->prevSize = topPrevSize_;
+        b->sizeBits = uint32_t(size);
+        topPrevSize_ = uint32_t(size);
+        top_ += size;
+        return b;
+    }
+
+    Block* takeLarge(size_t size) {
+        if (size < kMinBlock) { size = kMinBlock; } // must be able to hold `next`, `prev`
+        auto* b = large_;
+        while (b && b->size() < size) { b = b->next; }
+        if (!b) { return nullptr; }
+        unlink(b);
+
+        auto rest = b->size() - size;
+        if (rest >= kMinBlock) {
+            b->sizeBits = uint32_t(size);
+            auto* r = b->after();
+            r->prevSize = uint32_t(size);
+            r->sizeBits = uint32_t(rest);
+            if ((uint8_t*)r->after() == top_) {
+                topPrevSize_ = uint32_t(rest);
+            } else {
+                r->after()->prevSize = uint32_t(rest);
+            }
+            link(r);
+        }
+        return b;
+    }
+
+    void link(Block* b) {
+        b->prev = nullptr;
+        b->next = large_;
+        if (large_) { large_->prev = b; }
+        large_ = b;
+    }
+
+    void unlink(Block* b) {
+        (b->prev ? b->prev->next : large_) = b->next;
+        if (b->next) { b->next->prev = b->prev; }
+    }
+};
+
+inline Heap heap;
+
+inline Heap& defaultHeap() {
+    if (!heap.ready()) { heap.init(&__heap, &__heap_end); }
+    return heap;
+}
+
+} // namespace rp2350
+
+// On the host (`RP2350_HOST`) the C library keeps its own allocator; `Heap` itself can
+// still be used (e.g. benchmarked) over any buffer.
+#if !defined(RP2350_HOST)
+
+extern "C" {
+
+inline void* malloc(size_t n) { return rp2350::defaultHeap().alloc(n); }
+
+inline void free(void* p) { rp2350::defaultHeap().free(p); }
+
+inline void* calloc(size_t count, size_t n) {
+    auto size = count * n;
+    if (n && size / n != count) { return nullptr; }
+    auto* ret = malloc(size);
+    if (ret) { memset(ret, 0, size); }
+    return ret;
+}
+
+inline void* realloc(void* p, size_t n) {
+    if (!p) { return malloc(n); }
+    auto have = rp2350::Heap::usable(p);
+    if (n <= have) { return p; }
+    auto* ret = malloc(n);
+    if (ret) {
+        memcpy(ret, p, have);
+        free(p);
+    }
+    return ret;
+}
+
+} // extern "C"
+
+// Replacements for the default `operator new` and `delete`, made `weak` so including
+// this from several translation units doesn't produce duplicate definitions.  We build
+// with `-fno-exceptions`, so running out of memory in `new` is fatal.
+
+[[gnu::weak]] void* operator new(unsigned n) {
+    auto* ret = malloc(n);
+    if (!ret) { __abort(); }
+    return ret;
+}
+
+[[gnu::weak]] void* operator new[](unsigned n) { return operator new(n); }
+[[gnu::weak]] void operator delete(void* p) noexcept { free(p); }
+[[gnu::weak]] void operator delete[](void* p) noexcept { free(p); }
+[[gnu::weak]] void operator delete(void* p, unsigned) noexcept { free(p); }
+[[gnu::weak]] void operator delete[](void* p, unsigned) noexcept { free(p); }
+
+#endif // !RP2350_HOST
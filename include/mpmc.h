@@ -0,0 +1,137 @@
+#pragma once
+
+#include <platform.h>
+
+namespace rp2350 {
+
+// Bounded queue of `N` (a power of two) `T`s which any number of producers and
+// consumers may use at once: ISRs, thread code, and both cores, e.g. for work items
+// or log records.  This is Dmitry Vyukov's array queue: each cell carries a sequence
+// number saying whose turn it is (the producer for lap `k`, or the consumer), so
+// claiming a cell is one compare-and-swap on the shared enqueue or dequeue position
+// (LDREX/STREX on the M33), and handing it over is a release store to the cell.
+// Nothing spins waiting for another context, so a producer interrupted mid-push only
+// delays the consumer of that one cell; `tryPush` on a full queue and `tryPop` on an
+// empty one return false at once.
+//
+// Exclusives are coherent between the cores only in SRAM, where the bus fabric's
+// global monitor sees both.  For a queue anywhere else (e.g. PSRAM behind the XIP
+// cache), give it a `Lock` instead, such as an `IRQMutex` (`rp2350/mutex.h`): every
+// operation then runs under that lock, with plain loads and stores.
+//
+//     constinit IRQMutex gLogLock {kFirstSpinLock + 1};
+//     MpmcQueue<Record, 64, IRQMutex> gLog {&gLogLock};
+//
+// Cells store their sequence number relative to their index, so a zero-initialized
+// queue is ready to use (and a global one lives in `.bss`), as with `Pool`.
+template <class T, unsigned N, class Lock = void> struct MpmcQueue {
+    static_assert(N >= 2 && N <= 0x80000000u && !(N & (N - 1)));
+    constexpr static uint32_t kMask = N - 1;
+    constexpr static bool kLocked = !__is_same(Lock, void);
+
+    struct Cell {
+        uint32_t turn_; // sequence number, less this cell's index
+        T value_;
+    };
+
+    Lock* lock_ {};         // (unused unless `kLocked`)
+    uint32_t enqueue_ {};   // next position to push to
+    uint32_t dequeue_ {};   // next position to pop from
+    uint32_t retries_ {};   // claims lost to another context, which then went again
+    uint32_t full_ {};      // `tryPush`es refused
+    Cell cells_[N];
+
+    constexpr MpmcQueue() = default;
+    constexpr explicit MpmcQueue(Lock* lock) : lock_(lock) {}
+
+    constexpr static unsigned capacity() { return N; }
+
+    // Items held, as of some moment during the call
+    unsigned size() const {
+        auto head = __atomic_load_n(&dequeue_, __ATOMIC_ACQUIRE);
+        auto n = __atomic_load_n(&enqueue_, __ATOMIC_ACQUIRE) - head;
+        return n <= N ? n : 0; // (a pop got in between the loads)
+    }
+    bool empty() const { return !size(); }
+
+    unsigned retries() const { return __atomic_load_n(&retries_, __ATOMIC_RELAXED); }
+    unsigned full() const { return __atomic_load_n(&full_, __ATOMIC_RELAXED); }
+
+    bool tryPush(T const& x) {
+        Guard _ {lock_};
+        auto pos = __atomic_load_n(&enqueue_, __ATOMIC_RELAXED);
+        while (true) {
+            auto& cell = cells_[pos & kMask];
+            auto seq = __atomic_load_n(&cell.turn_, __ATOMIC_ACQUIRE) + (pos & kMask);
+            auto lag = int32_t(seq - pos);
+            if (!lag) {
+                // Our turn: claim the position, then fill the cell, then pass it on
+                if (claim(enqueue_, pos)) {
+                    cell.value_ = x;
+                    __atomic_store_n(&cell.turn_, pos + 1 - (pos & kMask),
+                                     __ATOMIC_RELEASE);
+                    return true;
+                }
+                __atomic_fetch_add(&retries_, 1, __ATOMIC_RELAXED);
+            } else if (lag < 0) {
+                // Its consumer from the last lap hasn't been yet: full
+                __atomic_fetch_add(&full_, 1, __ATOMIC_RELAXED);
+                return false;
+            } else {
+                // Another producer got here first
+                pos = __atomic_load_n(&enqueue_, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    bool tryPop(T& x) {
+        Guard _ {lock_};
+        auto pos = __atomic_load_n(&dequeue_, __ATOMIC_RELAXED);
+        while (true) {
+            auto& cell = cells_[pos & kMask];
+            auto seq = __atomic_load_n(&cell.turn_, __ATOMIC_ACQUIRE) + (pos & kMask);
+            auto lag = int32_t(seq - (pos + 1));
+            if (!lag) {
+                if (claim(dequeue_, pos)) {
+                    x = cell.value_;
+                    // Ready for the producer of the next lap
+                    __atomic_store_n(&cell.turn_, pos + N - (pos & kMask),
+                                     __ATOMIC_RELEASE);
+                    return true;
+                }
+                __atomic_fetch_add(&retries_, 1, __ATOMIC_RELAXED);
+            } else if (lag < 0) {
+                // Not yet filled: empty
+                return false;
+            } else {
+                pos = __atomic_load_n(&dequeue_, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+private:
+    struct Guard {
+        Lock* lock_;
+
+        [[gnu::always_inline]] explicit Guard(Lock* lock) : lock_(lock) {
+            if constexpr (kLocked) { lock_->lock(); }
+        }
+        [[gnu::always_inline]] ~Guard() {
+            if constexpr (kLocked) { lock_->unlock(); }
+        }
+    };
+
+    // Move `at` on from `pos`, if it's still there; otherwise false, with `pos`
+    // updated to where it is now
+    static bool claim(uint32_t& at, uint32_t& pos) {
+        if constexpr (kLocked) {
+            __atomic_store_n(&at, pos + 1, __ATOMIC_RELAXED);
+            return true;
+        } else {
+            return __atomic_compare_exchange_n(&at, &pos, pos + 1, true,
+                                               __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        }
+    }
+};
+
+} // namespace rp2350
@@ -2,6 +2,18 @@
 
 #pragma once
 
+#if defined(RP2350_HOST)
+// Host build (see `rp2350/sim.h`): use the compiler's own idea of these types, so that
+// they agree with the host C library's headers.
+using int8_t = __INT8_TYPE__;
+using int16_t = __INT16_TYPE__;
+using int32_t = __INT32_TYPE__;
+using int64_t = __INT64_TYPE__;
+using uint8_t = __UINT8_TYPE__;
+using uint16_t = __UINT16_TYPE__;
+using uint32_t = __UINT32_TYPE__;
+using uint64_t = __UINT64_TYPE__;
+#else
 using int8_t = char;
 using int16_t = short;
 using int32_t = long;
@@ -10,6 +22,7 @@ using uint8_t = unsigned char;
 using uint16_t = unsigned short;
 using uint32_t = unsigned long;
 using uint64_t = unsigned long long;
+#endif
 static_assert(sizeof(int8_t) == 1);
 static_assert(sizeof(int16_t) == 2);
 static_assert(sizeof(int32_t) == 4);
@@ -19,18 +32,24 @@ static_assert(sizeof(uint16_t) == 2);
 static_assert(sizeof(uint32_t) == 4);
 static_assert(sizeof(uint64_t) == 8);
 
+#if defined(RP2350_HOST)
+using intptr_t = __INTPTR_TYPE__;
+using uintptr_t = __UINTPTR_TYPE__;
+using size_t = __SIZE_TYPE__;
+using ssize_t = __PTRDIFF_TYPE__;
+using ptrdiff_t = __PTRDIFF_TYPE__;
+#else
 using intptr_t = int32_t;
 using uintptr_t = uint32_t;
-
 using size_t = uint32_t;
-static_assert(sizeof(size_t) == sizeof(void*));
-
 using ssize_t = int32_t;
 using ptrdiff_t = int32_t;
+#endif
+static_assert(sizeof(size_t) == sizeof(void*));
 
 typedef void (*vfunc)();
 
-void* operator new(unsigned, void* ptr) noexcept;
+void* operator new(decltype(sizeof(0)), void* ptr) noexcept;
 
 extern "C" {
 
@@ -48,55 +67,302 @@ inline void __unreachable() {
     __builtin_trap();        // (just in case)
 }
 
+// Memory copy engine, backing `memcpy`, `memmove` and the `__aeabi_mem*` functions.
+//
+// We build with `-mno-unaligned-access` (and `initCPUBasic` traps unaligned accesses)
+// so every load and store here is naturally aligned.  Large co-aligned copies go
+// through 32-byte LDM/STM bursts; when `src` and `dest` disagree on alignment, whole
+// words are read from `src` and shifted into place.
+//
+// NOTE: `-fno-builtin` is what keeps the byte loops below from being "optimized" into
+// calls to `memcpy`, the very thing we're defining.
+
+[[gnu::always_inline]]
+inline void __copyBytes(uint8_t* d, uint8_t const* s, size_t n) {
+    for (; n; --n) { *d++ = *s++; }
+}
+
+// Copy `blocks` 32-byte blocks, ascending.  `blocks` must be nonzero.
+[[gnu::always_inline]]
+inline void __copyBursts(uint32_t*& d, uint32_t const*& s, size_t blocks) {
+#if defined(__arm__)
+    // r7 is the frame pointer (`-fno-omit-frame-pointer`) so it's not in the list.
+    asm volatile("1:                                               \n"
+                 "ldmia %[s]!, {r3, r4, r5, r6, r8, r9, r10, r12}  \n"
+                 "stmia %[d]!, {r3, r4, r5, r6, r8, r9, r10, r12}  \n"
+                 "subs  %[n], #1                                   \n"
+                 "bne   1b                                         \n"
+                 : [d] "+r"(d), [s] "+r"(s), [n] "+r"(blocks)
+                 :
+                 : "r3", "r4", "r5", "r6", "r8", "r9", "r10", "r12", "cc", "memory");
+#else
+    for (; blocks; --blocks) {
+        for (unsigned i = 0; i < 8; i++) { *d++ = *s++; }
+    }
+#endif
+}
+
+// Copy `blocks` 32-byte blocks, descending (`d` and `s` point just past the end).
+[[gnu::always_inline]]
+inline void __copyBurstsBackward(uint32_t*& d, uint32_t const*& s, size_t blocks) {
+#if defined(__arm__)
+    asm volatile("1:                                               \n"
+                 "ldmdb %[s]!, {r3, r4, r5, r6, r8, r9, r10, r12}  \n"
+                 "stmdb %[d]!, {r3, r4, r5, r6, r8, r9, r10, r12}  \n"
+                 "subs  %[n], #1                                   \n"
+                 "bne   1b                                         \n"
+                 : [d] "+r"(d), [s] "+r"(s), [n] "+r"(blocks)
+                 :
+                 : "r3", "r4", "r5", "r6", "r8", "r9", "r10", "r12", "cc", "memory");
+#else
+    for (; blocks; --blocks) {
+        for (unsigned i = 0; i < 8; i++) { *--d = *--s; }
+    }
+#endif
+}
+
+// Both `d` and `s` word-aligned: copy all whole words, leaving `n < 4` bytes.
+[[gnu::always_inline]]
+inline void __copyAligned(uint32_t*& d, uint32_t const*& s, size_t& n) {
+    if (n >= 32) {
+        __copyBursts(d, s, n >> 5);
+        n &= 31;
+    }
+    for (; n >= 4; n -= 4) { *d++ = *s++; }
+}
+
+// `d` is word-aligned but `s` is not.  Read aligned source words and funnel-shift
+// each adjacent pair together (little-endian).  Every word read contains at least one
+// byte of the source range, so this never touches memory outside of it.
+[[gnu::always_inline]]
+inline void __copyShifted(uint32_t*& d, uint8_t const*& s, size_t& n) {
+    auto off = unsigned(uintptr_t(s) & 3); // 1, 2, or 3
+    auto lo = off * 8;
+    auto hi = 32 - lo;
+    auto* sw = (uint32_t const*)(uintptr_t(s) - off);
+    uint32_t w = *sw++;
+    for (; n >= 4; n -= 4) {
+        uint32_t next = *sw++;
+        *d++ = (w >> lo) | (next << hi);
+        w = next;
+    }
+    s = (uint8_t const*)(sw - 1) + off;
+}
+
+inline void __copyForward(uint8_t* d, uint8_t const* s, size_t n) {
+    if (n >= 8) {
+        // Byte-copy up to a word boundary in `dest`, then pick a word strategy
+        for (; uintptr_t(d) & 3; --n) { *d++ = *s++; }
+        auto* dw = (uint32_t*)d;
+        if (uintptr_t(s) & 3) {
+            __copyShifted(dw, s, n);
+        } else {
+            auto* sw = (uint32_t const*)s;
+            __copyAligned(dw, sw, n);
+            s = (uint8_t const*)sw;
+        }
+        d = (uint8_t*)dw;
+    }
+    __copyBytes(d, s, n);
+}
+
+inline void __copyBackward(uint8_t* d, uint8_t const* s, size_t n) {
+    d += n;
+    s += n;
+    if (n >= 8 && !((uintptr_t(d) ^ uintptr_t(s)) & 3)) {
+        for (; uintptr_t(d) & 3; --n) { *--d = *--s; }
+        auto* dw = (uint32_t*)d;
+        auto* sw = (uint32_t const*)s;
+        if (n >= 32) {
+            __copyBurstsBackward(dw, sw, n >> 5);
+            n &= 31;
+        }
+        for (; n >= 4; n -= 4) { *--dw = *--sw; }
+        d = (uint8_t*)dw;
+        s = (uint8_t const*)sw;
+    }
+    for (; n; --n) { *--d = *--s; }
+}
+
+// Memory fill engine, backing `memset` and `__aeabi_mem{set,clr}*`, as well as the
+// typed `fill16` / `fill32` below.  `pattern` is the byte (or halfword) value already
+// replicated across a whole word.
+
+[[gnu::always_inline]]
+inline void __fillBytes(uint8_t* d, uint8_t c, size_t n) {
+    for (; n; --n) { *d++ = c; }
+}
+
+// Store `blocks` 32-byte blocks of `pattern`.  `blocks` must be nonzero.
+[[gnu::always_inline]]
+inline void __fillBursts(uint32_t*& d, uint32_t pattern, size_t blocks) {
+#if defined(__arm__)
+    // r7 is the frame pointer (`-fno-omit-frame-pointer`) so it's not in the list.
+    asm volatile("mov   r3, %[v]                                   \n"
+                 "mov   r4, %[v]                                   \n"
+                 "mov   r5, %[v]                                   \n"
+                 "mov   r6, %[v]                                   \n"
+                 "mov   r8, %[v]                                   \n"
+                 "mov   r9, %[v]                                   \n"
+                 "mov   r10, %[v]                                  \n"
+                 "mov   r12, %[v]                                  \n"
+                 "1:                                               \n"
+                 "stmia %[d]!, {r3, r4, r5, r6, r8, r9, r10, r12}  \n"
+                 "subs  %[n], #1                                   \n"
+                 "bne   1b                                         \n"
+                 : [d] "+r"(d), [n] "+r"(blocks)
+                 : [v] "r"(pattern)
+                 : "r3", "r4", "r5", "r6", "r8", "r9", "r10", "r12", "cc", "memory");
+#else
+    for (; blocks; --blocks) {
+        for (unsigned i = 0; i < 8; i++) { *d++ = pattern; }
+    }
+#endif
+}
+
+// `d` word-aligned: fill all whole words, leaving `n < 4` bytes.
+[[gnu::always_inline]]
+inline void __fillAligned(uint32_t*& d, uint32_t pattern, size_t& n) {
+    if (n >= 32) {
+        __fillBursts(d, pattern, n >> 5);
+        n &= 31;
+    }
+    // Double-word stores (STRD) for what's left of the last burst, then one word
+    for (; n >= 8; n -= 8) {
+        d[0] = pattern;
+        d[1] = pattern;
+        d += 2;
+    }
+    if (n >= 4) {
+        *d++ = pattern;
+        n -= 4;
+    }
+}
+
+inline void __fillForward(uint8_t* d, uint32_t pattern, size_t n) {
+    if (n >= 8) {
+        for (; uintptr_t(d) & 3; --n) { *d++ = uint8_t(pattern); }
+        auto* dw = (uint32_t*)d;
+        __fillAligned(dw, pattern, n);
+        d = (uint8_t*)dw;
+    }
+    __fillBytes(d, uint8_t(pattern), n);
+}
+
 // C/C++ ABI-specified functions
 
 [[gnu::retain]] [[gnu::used]]
-inline void __aeabi_memcpy(uint8_t* dest, uint8_t const* src, uint32_t n) {
-    for (uint32_t i = 0; i < n; i++) {
-        // Read from source and write into dest; the do-nothing `asm volatile`
-        // is only to separate the read and write, to prevent fusing them and optimizing
-        // into a "memcpy" operation involving a call to `__aeabi_memcpy`, the very
-        // thing we're trying to define.
-        uint8_t x = src[i];
-        // asm volatile("");  // XXX actually needed??
-        dest[i] = x;
+inline void __aeabi_memcpy(void* dest, void const* src, size_t n) {
+    __copyForward((uint8_t*)dest, (uint8_t const*)src, n);
+}
+
+[[gnu::retain]] [[gnu::used]]
+inline void __aeabi_memcpy4(void* dest, void const* src, size_t n) {
+    // Both pointers are known to be word-aligned
+    auto* d = (uint32_t*)dest;
+    auto* s = (uint32_t const*)src;
+    __copyAligned(d, s, n);
+    __copyBytes((uint8_t*)d, (uint8_t const*)s, n);
+}
+
+[[gnu::retain]] [[gnu::used]]
+inline void __aeabi_memcpy8(void* dest, void const* src, size_t n) {
+    __aeabi_memcpy4(dest, src, n);
+}
+
+[[gnu::retain]] [[gnu::used]]
+inline void __aeabi_memmove(void* dest, void const* src, size_t n) {
+    // Copying forward is safe unless `dest` lies inside `[src, src + n)`; the unsigned
+    // subtraction covers both `dest < src` (wraps around) and `dest >= src + n`.
+    if (uintptr_t(dest) - uintptr_t(src) >= n) {
+        __copyForward((uint8_t*)dest, (uint8_t const*)src, n);
+    } else {
+        __copyBackward((uint8_t*)dest, (uint8_t const*)src, n);
     }
 }
 
 [[gnu::retain]] [[gnu::used]]
-inline void __aeabi_memcpy4(uint8_t* dest, uint8_t const* src, unsigned n) {
-    __aeabi_memcpy(dest, src, n);
+inline void __aeabi_memmove4(void* dest, void const* src, size_t n) {
+    __aeabi_memmove(dest, src, n);
+}
+
+[[gnu::retain]] [[gnu::used]]
+inline void __aeabi_memmove8(void* dest, void const* src, size_t n) {
+    __aeabi_memmove(dest, src, n);
+}
+
+// (Host builds get these three from the host's C library instead.)
+#if !defined(RP2350_HOST)
+
+inline void* memcpy(void* dst, void const* src, size_t n) {
+    __copyForward((uint8_t*)dst, (uint8_t const*)src, n);
+    return dst;
+}
+
+inline void* memmove(void* dst, void const* src, size_t n) {
+    __aeabi_memmove(dst, src, n);
+    return dst;
+}
+
+inline void* memset(void* dst, int c, size_t n) {
+    __fillForward((uint8_t*)dst, uint8_t(c) * 0x01010101u, n);
+    return dst;
+}
+
+#endif // !RP2350_HOST
+
+[[gnu::retain]] [[gnu::used]]
+inline void __aeabi_memset(void* dest, size_t n, int c) {
+    __fillForward((uint8_t*)dest, uint8_t(c) * 0x01010101u, n);
 }
 
-inline void* memcpy(void* dst_, void const* src_, size_t n) {
-    auto* dst = reinterpret_cast<char*>(dst_);
-    auto* src = reinterpret_cast<char const*>(src_);
-    for (size_t i = 0; i < n; i++) { dst[i] = src[i]; }
-    return dst_;
+[[gnu::retain]] [[gnu::used]]
+inline void __aeabi_memset4(void* dest, size_t n, int c) {
+    // `dest` is known to be word-aligned
+    auto* d = (uint32_t*)dest;
+    __fillAligned(d, uint8_t(c) * 0x01010101u, n);
+    __fillBytes((uint8_t*)d, uint8_t(c), n);
 }
 
-inline void* memset(void* dst_, int c_, size_t len) {
-    auto* dst = reinterpret_cast<char*>(dst_);
-    auto c = char(c_);
-    for (size_t i = 0; i < len; i++) { dst[i] = c; }
-    return dst_;
+[[gnu::retain]] [[gnu::used]]
+inline void __aeabi_memset8(void* dest, size_t n, int c) {
+    __aeabi_memset4(dest, n, c);
 }
 
 [[gnu::retain]] [[gnu::used]]
 inline void __aeabi_memclr(void* dest, size_t n) {
-    memset(dest, 0, n);
+    __fillForward((uint8_t*)dest, 0, n);
 }
 
 [[gnu::retain]] [[gnu::used]]
 inline void __aeabi_memclr4(void* dest, size_t n) {
-    memset(dest, 0, n);
+    __aeabi_memset4(dest, n, 0);
 }
 
 [[gnu::retain]] [[gnu::used]]
 inline void __aeabi_memclr8(void* dest, size_t n) {
-    memset(dest, 0, n);
+    __aeabi_memset4(dest, n, 0);
 }
 
 } // extern "C" ends
 
+// Fill `count` halfwords (e.g. RGB565 / RGB444 pixels) with `v`.  `d` must be at least
+// halfword-aligned.
+inline void fill16(uint16_t* d, uint16_t v, size_t count) {
+    if (count && (uintptr_t(d) & 2)) {
+        *d++ = v;
+        --count;
+    }
+    auto* dw = (uint32_t*)d;
+    size_t n = count << 1;
+    __fillAligned(dw, v | (uint32_t(v) << 16), n);
+    if (n) { *(uint16_t*)dw = v; }
+}
+
+// Fill `count` words with `v`.  `d` must be word-aligned.
+inline void fill32(uint32_t* d, uint32_t v, size_t count) {
+    size_t n = count << 2;
+    __fillAligned(d, v, n);
+}
+
 namespace __cxxabiv1 {} // namespace __cxxabiv1
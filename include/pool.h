@@ -0,0 +1,114 @@
+#pragma once
+
+#include <platform.h>
+
+namespace rp2350 {
+
+// Fixed-size pool of `N` blocks for `T` objects, with constant-time, lock-free
+// allocation and release.  Safe to share between thread and interrupt context and
+// across both cores: no interrupt masking and no global lock is involved.
+//
+// Free blocks are kept on a LIFO list whose head is updated with LDREX/STREX
+// (`__atomic_compare_exchange`).  The head word holds a block index in its low half
+// and a tag, bumped on every pop, in its high half; this makes an ABA sequence
+// (pop A, pop B, push A between another context's read and its update) fail the
+// exchange rather than corrupt the list.
+//
+// Blocks which have never been handed out aren't on the list; they're taken in order
+// from `fresh_`.  So a zero-initialized `Pool` is ready to use, and a global one lives
+// entirely in `.bss`.
+template <class T, unsigned N> struct Pool {
+    static_assert(N > 0 && N < 0xffff);
+
+    uint32_t head_ {};      // (tag << 16) | (index + 1); low half 0 if list is empty
+    uint32_t fresh_ {};     // blocks [fresh_, N) have never been handed out
+    uint32_t inUse_ {};     // blocks currently allocated
+    uint32_t highWater_ {}; // max of `inUse_` seen
+    uint32_t failures_ {};  // allocations which found the pool exhausted
+    uint16_t next_[N] {};   // link (index + 1) for each free block; 0 ends the list
+    alignas(T) uint8_t storage_[N][sizeof(T)];
+
+    unsigned inUse() const { return __atomic_load_n(&inUse_, __ATOMIC_RELAXED); }
+    unsigned highWater() const {
+        return __atomic_load_n(&highWater_, __ATOMIC_RELAXED);
+    }
+    unsigned failures() const { return __atomic_load_n(&failures_, __ATOMIC_RELAXED); }
+    constexpr static unsigned capacity() { return N; }
+
+    // Get an uninitialized block, or nullptr if the pool is exhausted.
+    void* alloc() {
+        int i = pop();
+        if (i < 0) { i = takeFresh(); }
+        if (i < 0) {
+            __atomic_fetch_add(&failures_, 1, __ATOMIC_RELAXED);
+            return nullptr;
+        }
+        auto n = __atomic_add_fetch(&inUse_, 1, __ATOMIC_RELAXED);
+        auto hw = __atomic_load_n(&highWater_, __ATOMIC_RELAXED);
+        while (n > hw && !__atomic_compare_exchange_n(&highWater_, &hw, n, true,
+                                                      __ATOMIC_RELAXED,
+                                                      __ATOMIC_RELAXED)) {}
+        return storage_[i];
+    }
+
+    // Return a block obtained from `alloc`.
+    void free(void* p) {
+        if (!p) { return; }
+        auto i = unsigned((uint8_t*)p - storage_[0]) / sizeof(T);
+        __atomic_fetch_sub(&inUse_, 1, __ATOMIC_RELAXED);
+        push(i);
+    }
+
+    template <class... A> T* make(A&&... args) {
+        auto* p = alloc();
+        return p ? new (p) T(static_cast<A&&>(args)...) : nullptr;
+    }
+
+    void destroy(T* obj) {
+        if (!obj) { return; }
+        obj->~T();
+        free(obj);
+    }
+
+private:
+    int pop() {
+        auto head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+        while (true) {
+            auto link = head & 0xffff;
+            if (!link) { return -1; }
+            // (If another context pops this block first, `next_` might be stale; but
+            // then the tag has moved on, and the exchange fails.)
+            auto next = __atomic_load_n(&next_[link - 1], __ATOMIC_RELAXED);
+            auto newHead = ((head + 0x10000) & 0xffff0000) | next;
+            if (__atomic_compare_exchange_n(&head_, &head, newHead, true,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+                return int(link - 1);
+            }
+        }
+    }
+
+    void push(unsigned i) {
+        auto head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        while (true) {
+            __atomic_store_n(&next_[i], uint16_t(head & 0xffff), __ATOMIC_RELAXED);
+            auto newHead = (head & 0xffff0000) | (i + 1);
+            if (__atomic_compare_exchange_n(&head_, &head, newHead, true,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+                return;
+            }
+        }
+    }
+
+    int takeFresh() {
+        auto i = __atomic_load_n(&fresh_, __ATOMIC_RELAXED);
+        while (i < N) {
+            if (__atomic_compare_exchange_n(&fresh_, &i, i + 1, true, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                return int(i);
+            }
+        }
+        return -1;
+    }
+};
+
+} // namespace rp2350
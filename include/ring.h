@@ -0,0 +1,156 @@
+#pragma once
+
+#include <platform.h>
+
+namespace rp2350 {
+
+// A run of `n` contiguous `T`s; a pointer and a length, nothing owned
+template <class T> struct Span {
+    T* data_ {};
+    unsigned size_ {};
+
+    unsigned size() const { return size_; }
+    bool empty() const { return !size_; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+    T& operator[](unsigned i) const { return data_[i]; }
+
+    template <class U = T> operator Span<U const>() const { return {data_, size_}; }
+};
+
+// Ring buffer of `N` (a power of two) `T`s between one producer and one consumer,
+// e.g. an ISR and thread code, or the two cores.  Neither side locks or masks
+// interrupts: each only writes its own index, publishing it with a release store
+// after touching the slots, and reads the other's with an acquire load (LDA/STL on
+// the M33), so slots are never seen half-written.
+//
+// The indices run freely and are masked on use, so all `N` slots are usable and no
+// `%` is needed.  Besides single items, each side can work in bulk: `write` / `read`
+// copy spans in at most two pieces, and for zero-copy use (e.g. a DMA channel or a
+// UART FIFO on the far side) `writeRegion` / `readRegion` return the next contiguous
+// stretch of free / filled slots, which `commitWrite` / `commitRead` then hand over.
+//
+// Nothing here blocks: a full ring refuses what won't fit and counts it in
+// `overflows_`, and an empty one gives nothing; it's up to the caller whether to
+// drop, retry or sleep.  (A producer which waits for room rather than dropping should
+// wait on `full()` before pushing, so waiting isn't counted as overflowing.)
+template <class T, unsigned N> struct SpscRing {
+    static_assert(N >= 2 && N <= 0x80000000u && !(N & (N - 1)));
+    constexpr static uint32_t kMask = N - 1;
+
+    uint32_t head_ {};      // consumer's: next slot to read
+    uint32_t tail_ {};      // producer's: next slot to write
+    uint32_t overflows_ {}; // producer's: `push`es and `write`s refused all or part
+    uint32_t highWater_ {}; // producer's: most items held at once, as it saw it
+    T slots_[N];
+
+    constexpr static unsigned capacity() { return N; }
+
+    // Items held; exact from either side, a snapshot from anywhere else
+    unsigned size() const {
+        auto head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+        return __atomic_load_n(&tail_, __ATOMIC_ACQUIRE) - head;
+    }
+    bool empty() const { return !size(); }
+    bool full() const { return size() == N; }
+
+    unsigned overflows() const {
+        return __atomic_load_n(&overflows_, __ATOMIC_RELAXED);
+    }
+    unsigned highWater() const {
+        return __atomic_load_n(&highWater_, __ATOMIC_RELAXED);
+    }
+
+    // Producer side
+
+    bool push(T const& x) {
+        auto tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+        if (tail - __atomic_load_n(&head_, __ATOMIC_ACQUIRE) == N) {
+            overflowed();
+            return false;
+        }
+        slots_[tail & kMask] = x;
+        commitWrite(1);
+        return true;
+    }
+
+    // The free slots from the write position up to the end of the ring or the first
+    // filled slot; fill some and `commitWrite` them
+    Span<T> writeRegion() {
+        auto tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+        auto room = N - (tail - __atomic_load_n(&head_, __ATOMIC_ACQUIRE));
+        auto end = N - (tail & kMask);
+        return {&slots_[tail & kMask], room < end ? room : end};
+    }
+
+    // Hand the next `n` slots (from `writeRegion`) to the consumer
+    void commitWrite(unsigned n) {
+        auto tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED) + n;
+        __atomic_store_n(&tail_, tail, __ATOMIC_RELEASE);
+        auto held = tail - __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        if (held > highWater_) {
+            __atomic_store_n(&highWater_, held, __ATOMIC_RELAXED);
+        }
+    }
+
+    // Copy in as much of `xs` as fits; returns how many went
+    unsigned write(Span<T const> xs) {
+        unsigned done = 0;
+        for (unsigned piece = 0; piece < 2 && done < xs.size(); ++piece) {
+            auto region = writeRegion();
+            auto n = xs.size() - done;
+            if (n > region.size()) { n = region.size(); }
+            for (unsigned i = 0; i < n; i++) { region[i] = xs[done + i]; }
+            commitWrite(n);
+            done += n;
+        }
+        if (done < xs.size()) { overflowed(); }
+        return done;
+    }
+
+    // Consumer side
+
+    bool pop(T& x) {
+        auto head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        if (head == __atomic_load_n(&tail_, __ATOMIC_ACQUIRE)) { return false; }
+        x = slots_[head & kMask];
+        __atomic_store_n(&head_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    // The filled slots from the read position up to the end of the ring or the first
+    // free slot; use some and `commitRead` them
+    Span<T> readRegion() {
+        auto head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        auto held = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE) - head;
+        auto end = N - (head & kMask);
+        return {&slots_[head & kMask], held < end ? held : end};
+    }
+
+    // Hand the next `n` slots (from `readRegion`) back to the producer
+    void commitRead(unsigned n) {
+        auto head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        __atomic_store_n(&head_, head + n, __ATOMIC_RELEASE);
+    }
+
+    // Copy out up to `xs.size()` items; returns how many
+    unsigned read(Span<T> xs) {
+        unsigned done = 0;
+        for (unsigned piece = 0; piece < 2 && done < xs.size(); ++piece) {
+            auto region = readRegion();
+            auto n = xs.size() - done;
+            if (n > region.size()) { n = region.size(); }
+            for (unsigned i = 0; i < n; i++) { xs[done + i] = region[i]; }
+            commitRead(n);
+            done += n;
+        }
+        return done;
+    }
+
+private:
+    void overflowed() {
+        __atomic_store_n(&overflows_, overflows_ + 1, __ATOMIC_RELAXED);
+    }
+};
+
+} // namespace rp2350
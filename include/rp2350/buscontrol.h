@@ -18,14 +18,64 @@ struct BusControl {
         unsigned          : 19;
     };
 
-    Priority priority; // 0x00
+    // 12.15.2. Bus Performance Counters: one "port" per crossbar downstream port,
+    // each having four events.  Select with `(port << 2) | event`.
+    enum class Port : unsigned {
+        SIOB_PROC1 = 0,
+        SIOB_PROC0 = 1,
+        APB = 2,
+        FASTPERI = 3,
+        SRAM9 = 4,
+        SRAM8 = 5,
+        SRAM7 = 6,
+        SRAM6 = 7,
+        SRAM5 = 8,
+        SRAM4 = 9,
+        SRAM3 = 10,
+        SRAM2 = 11,
+        SRAM1 = 12,
+        SRAM0 = 13,
+        XIP_MAIN1 = 14,
+        XIP_MAIN0 = 15,
+        ROM = 16,
+    };
+
+    enum class Event : unsigned {
+        STALL_UPSTREAM = 0,   // cycles where any master stalled, for any reason
+        STALL_DOWNSTREAM = 1, // cycles where any master stalled on the downstream bus
+        ACCESS_CONTESTED = 2, // accesses which were stalled by another master
+        ACCESS = 3,           // all accesses
+    };
+
+    struct PerfCounter {
+        uint32_t value;  // 24 bits, saturating; write any value to clear
+        uint32_t select; // `(port << 2) | event`
+    };
+
+    Priority priority;      // 0x00
+    uint32_t priorityAck;   // 0x04
+    uint32_t perfEnable;    // 0x08
+    PerfCounter counter[4]; // 0x0c
+
+    // Point counter `i` at an event, and clear it
+    void perfSelect(unsigned i, Port port, Event event) {
+        counter[i].select = (unsigned(port) << 2) | unsigned(event);
+        counter[i].value = 0;
+        perfEnable = 1;
+    }
+
+    uint32_t perfRead(unsigned i) const { return counter[i].value; }
 };
 inline auto& busControl = *(BusControl*)(0x40068000);
 
 [[gnu::noinline]] [[gnu::retain]] [[gnu::used]] [[gnu::section(".systext")]]
 inline void initBusControl(bool prioritizeDMA = true) {
     resets.unreset(Resets::Bit::BUSCTRL, true);
-    busControl.priority.dmaRead = prioritizeDMA;
+    if (prioritizeDMA) {
+        atomicSet(&busControl.priority, [](auto& _) { _->dmaRead = true; });
+    } else {
+        atomicClr(&busControl.priority, [](auto& _) { _->dmaRead = true; });
+    }
 }
 
 } // namespace rp2350
@@ -10,11 +10,25 @@ extern void __start();
 // Defined in the linker script
 extern void* __sram_begin;
 extern void* __sram_end;
+extern void* __time_critical_flash_begin;
+extern void* __time_critical_sram_begin;
+extern void* __time_critical_sram_end;
 extern void* __data_flash_begin;
 extern void* __data_sram_begin;
 extern void* __data_sram_end;
 extern void* __init_array_begin;
 extern void* __init_array_end;
+extern void* __bss_begin;
+extern void* __bss_end;
+extern void* __tdata_begin;
+extern void* __tdata_end;
+extern void* __tbss_end;
+extern void* __tls_offset; // (an absolute symbol: use its address)
+extern void* __tls_block;  // (likewise)
+extern void* __tls_core0;
+extern void* __tls_core1;
+extern void* __heap;
+extern void* __heap_end;
 
 } // extern "C"
 
@@ -76,12 +90,15 @@ struct U16 {
     uint16_t& u16() { return *reinterpret_cast<uint16_t*>(this); }
 };
 
+// Value of one register being built up by `update` or `overwrite`; fields are set
+// through `->`, as in `_->enable = true`.
 template <class R, class NVR = __remove_volatile(R)> struct Update {
     R* reg_;
     uint32_t val_;
 
     ~Update() { write(); }
     Update(R* reg) : reg_(reg), val_(*(uint32_t*)reg) {}
+    Update(R* reg, uint32_t val) : reg_(reg), val_(val) {}
 
     NVR* operator->() { return (NVR*)&val_; }
 
@@ -96,9 +113,127 @@ template <class R, class NVR = __remove_volatile(R)> struct Update {
     }
 };
 
-template <class R> void update(R* reg, auto cb) {
-    Update u(reg);
-    cb(u);
+// The register value `update` and friends' callbacks see at compile time: nothing in
+// it is initialized, so a callback reading a field it hasn't assigned (or `zero()`ed)
+// isn't a constant expression.
+template <class NVR> struct FieldWrites {
+    NVR val_;
+
+    constexpr NVR* operator->() { return &val_; }
+
+    constexpr auto& zero() {
+        val_ = NVR {};
+        return *this;
+    }
+};
+
+// Run `cb` against `FieldWrites`, with default-constructed stand-ins for its arguments;
+// this fails to compile if `cb` reads a field before assigning it.
+template <class R, class CB, class... A> consteval bool writesOnly() {
+    static_assert(__is_empty(CB), "pass run-time values to `cb` as arguments");
+    FieldWrites<__remove_volatile(R)> w;
+    CB {}(w, A {}...);
+    return true;
+}
+
+// Apply all the field writes made by `cb` with (at most) one register access, e.g.:
+//
+//     update(&m33.ccr(), [](auto& _) {
+//         _->unalignedTrap = true;
+//         _->div0Trap = true;
+//     });
+//
+// Values known only at run time are passed after `cb`, which takes them after `_`:
+//
+//     update(&c.ctrl, [](auto& _, unsigned ch) { _->chainTo = ch & 15; }, ch);
+//
+// `cb` may only assign fields (or call `zero()`): it never sees the register, and a
+// read of a field it hasn't assigned itself doesn't compile (see `writesOnly`).  It's
+// run against two probes, all-zeroes and all-ones; bits coming out the same from both
+// were written by `cb`, and the rest are preserved.  To change a field relative to its
+// current value, read the register first and pass the result in.  (The check follows
+// `cb` with its arguments' default values, so keep it free of branches on them.)
+//
+// When `cb` assigns constants this folds away at compile time, leaving a single store
+// if every bit is written (e.g. after `zero()`), or else a single read-modify-write.
+template <class R, class CB, class... A> void update(R* reg, CB cb, A... args) {
+    static_assert(writesOnly<R, CB, A...>());
+    Update<R> lo(nullptr, 0);
+    Update<R> hi(nullptr, ~uint32_t(0));
+    [[clang::always_inline]] cb(lo, args...);
+    [[clang::always_inline]] cb(hi, args...);
+    auto mask = ~(lo.val_ ^ hi.val_);
+    auto bits = lo.val_ & mask;
+    auto* p = (uint32_t volatile*)reg;
+    if (mask == ~uint32_t(0)) {
+        *p = bits;
+    } else {
+        *p = (*p & ~mask) | bits;
+    }
 };
 
+// Store the fields set by `cb`, with all other bits zero, never reading the register;
+// for write-only registers, or those where a read has side effects.
+template <class R, class CB, class... A> void overwrite(R* reg, CB cb, A... args) {
+    static_assert(writesOnly<R, CB, A...>());
+    Update<R> u(nullptr, 0);
+    [[clang::always_inline]] cb(u, args...);
+    *(uint32_t volatile*)reg = u.val_;
+};
+
+// 2.1.3. Atomic Register Access
+//
+// Peripheral registers have aliases which apply a write as an atomic XOR (+0x1000),
+// bitmask set (+0x2000), or bitmask clear (+0x3000) of the register's bits, all in a
+// single bus write; no read, and so nothing for an ISR or the other core to race with.
+// This does *not* apply to SIO (which has its own SET/CLR/XOR registers) or to the
+// Cortex-M33's registers at 0xe0000000.
+//
+// The callback forms take the bits to flip from the fields `cb` assigns (starting from
+// all-zeroes), e.g. `atomicClr(&pads, [](auto& _) { _->isolation = true; })`; they
+// take run-time values, and are checked, as `update` is.
+
+constexpr static uintptr_t kAtomicXor = 0x1000;
+constexpr static uintptr_t kAtomicSet = 0x2000;
+constexpr static uintptr_t kAtomicClr = 0x3000;
+
+template <class R> void atomicXor(R* reg, uint32_t bits) {
+    *(uint32_t volatile*)(uintptr_t(reg) + kAtomicXor) = bits;
+}
+
+template <class R> void atomicSet(R* reg, uint32_t bits) {
+    *(uint32_t volatile*)(uintptr_t(reg) + kAtomicSet) = bits;
+}
+
+template <class R> void atomicClr(R* reg, uint32_t bits) {
+    *(uint32_t volatile*)(uintptr_t(reg) + kAtomicClr) = bits;
+}
+
+template <class R, class F, class... A>
+    requires(__is_class(F))
+void atomicXor(R* reg, F cb, A... args) {
+    static_assert(writesOnly<R, F, A...>());
+    Update<R> u(nullptr, 0);
+    [[clang::always_inline]] cb(u, args...);
+    atomicXor(reg, u.val_);
+}
+
+template <class R, class F, class... A>
+    requires(__is_class(F))
+void atomicSet(R* reg, F cb, A... args) {
+    static_assert(writesOnly<R, F, A...>());
+    Update<R> u(nullptr, 0);
+    [[clang::always_inline]] cb(u, args...);
+    atomicSet(reg, u.val_);
+}
+
+template <class R, class F, class... A>
+    requires(__is_class(F))
+void atomicClr(R* reg, F cb, A... args) {
+    static_assert(writesOnly<R, F, A...>());
+    Update<R> u(nullptr, 0);
+    [[clang::always_inline]] cb(u, args...);
+    atomicClr(reg, u.val_);
+}
+
 } // namespace rp2350
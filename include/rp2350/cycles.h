@@ -0,0 +1,129 @@
+#pragma once
+
+#include <format.h>
+#include <platform.h>
+#include <rp2350/m33.h>
+
+namespace rp2350 {
+
+// Cycle counts for regions of code, from the DWT cycle counter (which `__reset` starts;
+// see `M33::startCycleCounter`).  Declare one counter per region, at namespace scope
+// so it's constant-initialized, and time the region with a `ScopedCycles`:
+//
+//     constinit CycleCounter gTxCycles {"tx"};
+//
+//     void tx() {
+//         ScopedCycles _ {gTxCycles};
+//         ...
+//     }
+//
+// then print every counter which has recorded anything with `dumpCycles`, e.g.
+// `dumpCycles([](char const* s) { uart0.write(s); })`.
+//
+// Readings include the couple of cycles it takes to read CYCCNT, and are limited to
+// 2^32 cycles (about 34s at 126MHz).  Update each counter from one context only (one
+// ISR, or thread code); the list of counters itself may be joined from anywhere.
+
+struct CycleCounter {
+    char const* name_;
+    CycleCounter* next_ {}; // next in `cycleCounters`
+    uint32_t linked_ {};    // nonzero once on that list
+    uint32_t count_ {};
+    uint32_t min_ {~uint32_t(0)};
+    uint32_t max_ {};
+    uint64_t total_ {};
+
+    constexpr explicit CycleCounter(char const* name) : name_(name) {}
+
+    void add(uint32_t cycles) {
+        if (!linked_) { link(); }
+        ++count_;
+        total_ += cycles;
+        if (cycles < min_) { min_ = cycles; }
+        if (cycles > max_) { max_ = cycles; }
+    }
+
+    void reset() {
+        count_ = 0;
+        min_ = ~uint32_t(0);
+        max_ = 0;
+        total_ = 0;
+    }
+
+    // Mean cycles per reading: 64-by-32-bit long division, one bit at a time, as
+    // there's no 64-bit divide instruction (and it's only needed for dumps)
+    uint32_t mean() const {
+        if (!count_) { return 0; }
+        uint64_t rem = 0;
+        uint32_t quot = 0; // fits, as the mean is at most `max_`
+        for (int bit = 63; bit >= 0; --bit) {
+            rem = (rem << 1) | ((total_ >> bit) & 1);
+            quot <<= 1;
+            if (rem >= count_) {
+                rem -= count_;
+                quot |= 1;
+            }
+        }
+        return quot;
+    }
+
+    void link();
+};
+
+// Every counter which has been added to, most recently joined first
+inline CycleCounter* cycleCounters;
+
+// Pushed with LDREX/STREX, as a counter may first be used in an ISR which interrupts
+// another counter's first use
+inline void CycleCounter::link() {
+    if (__atomic_exchange_n(&linked_, 1, __ATOMIC_RELAXED)) { return; }
+    auto* head = __atomic_load_n(&cycleCounters, __ATOMIC_RELAXED);
+    do {
+        next_ = head;
+    } while (!__atomic_compare_exchange_n(
+        &cycleCounters, &head, this, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+// Adds the cycles between its construction and destruction to a counter
+struct ScopedCycles {
+    CycleCounter& counter_;
+    uint32_t start_;
+
+    [[gnu::always_inline]] explicit ScopedCycles(CycleCounter& counter)
+            : counter_(counter), start_(m33.cycles()) {}
+
+    [[gnu::always_inline]] ~ScopedCycles() { counter_.add(m33.cycles() - start_); }
+};
+
+inline void resetCycleCounters() {
+    for (auto* c = cycleCounters; c; c = c->next_) { c->reset(); }
+}
+
+// One line per counter, e.g. "tx  n=5120 min=812 mean=840 max=1733 total=4300800",
+// passed as a string to `write`
+template <class W> void dumpCycles(W write) {
+    for (auto* c = __atomic_load_n(&cycleCounters, __ATOMIC_ACQUIRE); c; c = c->next_) {
+        char line[128];
+        auto* p = line;
+        auto append = [&](char const* s) {
+            while (*s) { *p++ = *s++; }
+        };
+        for (auto* s = c->name_; *s && p < line + 32; ++s) { *p++ = *s; }
+        while (p < line + 16) { *p++ = ' '; }
+        append(" n=");
+        p = formatDec(p, c->count_);
+        append(" min=");
+        p = formatDec(p, c->count_ ? c->min_ : 0);
+        append(" mean=");
+        p = formatDec(p, c->mean());
+        append(" max=");
+        p = formatDec(p, c->max_);
+        append(" total=");
+        p = formatDec(p, c->total_);
+        *p++ = '\n';
+        *p = 0;
+        write((char const*)line);
+    }
+}
+
+} // namespace rp2350
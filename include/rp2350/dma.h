@@ -2,6 +2,7 @@
 
 #include <platform.h>
 #include <rp2350/common.h>
+#include <rp2350/insns.h>
 #include <rp2350/resets.h>
 
 namespace rp2350 {
@@ -105,4 +106,230 @@ inline auto& dma = *(DMA*)(0x50000000);
 
 inline void initDMA() { resets.unreset(Resets::Bit::DMA, true); }
 
+// Bulk copies and fills on a spare DMA channel, so they can run alongside the CPU.
+//
+// Channels are handed out from a claim mask.  Code which programs channels itself
+// (like the HSTX feed in `examples/HDMI.cc`) should claim those channels up front so
+// they're never picked here.
+
+constexpr static unsigned kDMATReqPermanent = 0x3f; // p.1102: unpaced transfers
+constexpr static size_t kDMAMinBytes = 256;         // smaller copies stay on the CPU
+
+inline uint32_t dmaClaimed = 0;      // bit N: channel N is in use
+inline uint32_t dmaFillWords[16] {}; // source word for each channel's `dmaFill`
+
+inline bool claimDMAChannel(unsigned ch) {
+    auto bit = uint32_t(1) << ch;
+    return !(__atomic_fetch_or(&dmaClaimed, bit, __ATOMIC_ACQ_REL) & bit);
+}
+
+inline int claimDMAChannel() {
+    for (unsigned ch = 0; ch < 16; ch++) {
+        if (claimDMAChannel(ch)) { return int(ch); }
+    }
+    return -1;
+}
+
+inline void releaseDMAChannels(uint32_t mask) {
+    __atomic_fetch_and(&dmaClaimed, ~mask, __ATOMIC_RELEASE);
+}
+
+inline void releaseDMAChannel(unsigned ch) { releaseDMAChannels(uint32_t(1) << ch); }
+
+// Completion handle returned by `dmaCopy`, `dmaFill` and `DMAChain::start`.  The
+// channels are released once `done` has seen the transfer finish (`wait` spins on
+// `done`).
+struct DMAJob {
+    int channel {-1};    // -1 when the CPU did the work (i.e. it's already complete)
+    uint32_t chained {}; // a chain's other channels, released along with `channel`
+
+    bool done() {
+        if (channel < 0) { return true; }
+        if (chained) {
+            // The chain's last channel isn't busy until the chain gets to it; go by
+            // its raw interrupt status instead, which `dmaSetup` cleared
+            auto raw = *(uint32_t volatile*)&dma.rawStatus;
+            if (!((raw >> channel) & 1)) { return false; }
+        } else {
+            auto volatile& ch = dma.channels[channel];
+            if (ch.ctrl.busy) { return false; }
+        }
+        release();
+        return true;
+    }
+
+    void wait() {
+        while (!done()) { __nop(); }
+    }
+
+    // Hand the channels back, once the transfer is known to have finished
+    void release() {
+        if (channel < 0) { return; }
+        asm volatile("" : : : "memory"); // CPU reads of the destination come after this
+        releaseDMAChannels((uint32_t(1) << channel) | chained);
+        channel = -1;
+        chained = 0;
+    }
+};
+
+// Set channel `ch` up for an unpaced transfer of `count` items; always writes
+// ascending, reads ascending only if `incrRead` (otherwise it rereads the same source
+// item).  It starts at once if `trigger`, or else when triggered (e.g. by the channel
+// before it in a chain), and on finishing triggers `chainTo` (`ch` itself: nothing).
+// Completion sets the channel's raw interrupt status, which raises an IRQ only where
+// the channel is enabled in an IRQ's mask (see `dmaDone` in `taskio.h`).
+inline void dmaSetup(unsigned ch, void* dst, void const* src, size_t count,
+                     DMA::DataSize dataSize, bool incrRead, unsigned chainTo,
+                     bool trigger) {
+    auto& c = dma.channels[ch];
+    c.readAddr = uintptr_t(src);
+    c.writeAddr = uintptr_t(dst);
+    overwrite(
+        &c.transCount,
+        [](auto& _, size_t count) {
+            _->count = unsigned(count) & 0x0fffffff;
+            _->mode = DMA::Mode::NORMAL;
+        },
+        count);
+    dma.rawStatus = uint32_t(1) << ch; // drop any completion left from its last job
+    asm volatile("" : : : "memory"); // CPU writes to the source land before the trigger
+    update(
+        trigger ? &c.ctrlTrig : &c.ctrl,
+        [](auto& _, DMA::DataSize dataSize, bool incrRead, unsigned chainTo) {
+            _.zero();
+            _->dataSize = dataSize;
+            _->incrRead = incrRead;
+            _->incrWrite = true;
+            _->chainTo = chainTo & 15;
+            _->treqSel = kDMATReqPermanent;
+            _->enable = true;
+        },
+        dataSize, incrRead, chainTo);
+}
+
+// Start a transfer on channel `ch` right away (see `dmaSetup`)
+inline void dmaStart(unsigned ch, void* dst, void const* src, size_t count,
+                     DMA::DataSize dataSize, bool incrRead) {
+    dmaSetup(ch, dst, src, count, dataSize, incrRead, ch, true);
+}
+
+// The CPU copies the unaligned head and tail bytes, and channel `ch` is set up for the
+// rest: as words if `src` and `dst` are co-aligned, else as bytes
+inline void dmaSetupCopy(unsigned ch, void* dst, void const* src, size_t n,
+                         unsigned chainTo, bool trigger) {
+    auto* d = (uint8_t*)dst;
+    auto* s = (uint8_t const*)src;
+    size_t head = (4 - (uintptr_t(d) & 3)) & 3;
+    __aeabi_memcpy(d, s, head);
+    d += head;
+    s += head;
+    n -= head;
+
+    if (uintptr_t(s) & 3) {
+        dmaSetup(ch, d, s, n, DMA::DataSize::_8BIT, true, chainTo, trigger);
+    } else {
+        size_t body = n & ~size_t(3);
+        __aeabi_memcpy(d + body, s + body, n - body);
+        dmaSetup(ch, d, s, body >> 2, DMA::DataSize::_32BIT, true, chainTo, trigger);
+    }
+}
+
+// Likewise for a fill, which the channel does as words
+inline void dmaSetupFill(unsigned ch, void* dst, uint8_t c, size_t n, unsigned chainTo,
+                         bool trigger) {
+    auto* d = (uint8_t*)dst;
+    size_t head = (4 - (uintptr_t(d) & 3)) & 3;
+    __aeabi_memset(d, head, c);
+    d += head;
+    n -= head;
+
+    size_t body = n & ~size_t(3);
+    __aeabi_memset(d + body, n - body, c);
+    dmaFillWords[ch] = c * 0x01010101u;
+    dmaSetup(ch, d, &dmaFillWords[ch], body >> 2, DMA::DataSize::_32BIT, false,
+             chainTo, trigger);
+}
+
+// Copy `n` bytes from `src` to `dst` (which must not overlap).  Small copies, or any
+// copy when no channel is free, are done right away by the CPU.  Otherwise the CPU
+// copies the unaligned head and tail bytes and a DMA channel moves the rest (see
+// `dmaSetupCopy`).
+inline DMAJob dmaCopy(void* dst, void const* src, size_t n) {
+    int ch = (n >= kDMAMinBytes) ? claimDMAChannel() : -1;
+    if (ch < 0) {
+        __aeabi_memcpy(dst, src, n);
+        return {};
+    }
+    dmaSetupCopy(unsigned(ch), dst, src, n, unsigned(ch), true);
+    return {ch};
+}
+
+// Fill `n` bytes at `dst` with byte `c`, in the same manner as `dmaCopy`.
+inline DMAJob dmaFill(void* dst, uint8_t c, size_t n) {
+    int ch = (n >= kDMAMinBytes) ? claimDMAChannel() : -1;
+    if (ch < 0) {
+        __aeabi_memset(dst, n, c);
+        return {};
+    }
+    dmaSetupFill(unsigned(ch), dst, c, n, unsigned(ch), true);
+    return {ch};
+}
+
+// Copies and fills run back to back by the DMA, e.g. to gather a header and a payload
+// into one buffer: each piece gets a channel of its own, chained to the next in
+// hardware (CHAIN_TO), so the CPU only starts the first.
+//
+// Pieces are split between the CPU and the DMA as by `dmaCopy` / `dmaFill`, and the
+// CPU's parts (small pieces, head and tail bytes, pieces for which no channel was
+// free) are done as they're added, ahead of the DMA's; so the pieces mustn't depend
+// on each other.  `start` hands back one `DMAJob` for the lot.
+struct DMAChain {
+    int first_ {-1};
+    int last_ {-1};
+    uint32_t channels_ {}; // claimed so far
+
+    void copy(void* dst, void const* src, size_t n) {
+        int ch = (n >= kDMAMinBytes) ? claimDMAChannel() : -1;
+        if (ch < 0) {
+            __aeabi_memcpy(dst, src, n);
+            return;
+        }
+        dmaSetupCopy(unsigned(ch), dst, src, n, unsigned(ch), false);
+        append(unsigned(ch));
+    }
+
+    void fill(void* dst, uint8_t c, size_t n) {
+        int ch = (n >= kDMAMinBytes) ? claimDMAChannel() : -1;
+        if (ch < 0) {
+            __aeabi_memset(dst, n, c);
+            return;
+        }
+        dmaSetupFill(unsigned(ch), dst, c, n, unsigned(ch), false);
+        append(unsigned(ch));
+    }
+
+    DMAJob start() {
+        if (first_ < 0) { return {}; }
+        asm volatile("" : : : "memory"); // (as in `dmaSetup`)
+        dma.multiChanTrigger.channels = uint32_t(1) << first_;
+        DMAJob job {last_, channels_ & ~(uint32_t(1) << last_)};
+        *this = {};
+        return job;
+    }
+
+private:
+    void append(unsigned ch) {
+        if (last_ < 0) {
+            first_ = int(ch);
+        } else {
+            // (Not yet started, so this is safe to change)
+            update(
+                &dma.channels[last_].ctrl,
+                [](auto& _, unsigned ch) { _->chainTo = ch & 15; }, ch);
+        }
+        last_ = int(ch);
+        channels_ |= uint32_t(1) << ch;
+    }
+};
+
 } // namespace rp2350
@@ -4,6 +4,7 @@
 #include <rp2350/common.h>
 #include <rp2350/pads.h>
 #include <rp2350/resets.h>
+#include <rp2350/sio.h>
 
 namespace rp2350 {
 
@@ -98,43 +99,6 @@ struct GPIO {
 };
 inline auto& gpio = *(GPIO*)(0x40028000);
 
-// Section 9.8, Processor GPIO Controls (SIO)
-// https://datasheets.raspberrypi.com/rp2350/rp2350-datasheet.pdf
-//
-// Note that for simplicity this only supports Bank0.
-// We'll assume Bank1 is not dealt with; the pins in Bank1
-// will then continue to be reserved only for QSPI.
-struct SIO : R32 {
-    unsigned cpuID;         // 0xd0000000
-    unsigned gpioIn;        // 0xd0000004
-    unsigned z_008;         // 0xd0000008
-    unsigned z_00c;         // 0xd000000c
-    unsigned gpioOut;       // 0xd0000010
-    unsigned z_014;         // 0xd0000014
-    unsigned gpioOutSet;    // 0xd0000018
-    unsigned z_01c;         // 0xd000001c
-    unsigned gpioOutClr;    // 0xd0000020
-    unsigned z_0;           // 0xd0000024
-    unsigned gpioOutXor;    // 0xd0000028
-    unsigned z_02c;         // 0xd000002c
-    unsigned gpioOutEnb;    // 0xd0000030
-    unsigned z_034;         // 0xd0000034
-    unsigned gpioOutEnbSet; // 0xd0000038
-    unsigned z_03c;         // 0xd000003c
-    unsigned gpioOutEnbClr; // 0xd0000040
-    unsigned z_044;         // 0xd0000044
-    unsigned gpioOutEnbXor; // 0xd0000048
-
-    // TODO:
-    // fifo(Status,Write)
-    // spinlockState
-    // 0x080 - 0x0bc , INTERP0
-    // 0x0c0 - 0x0fc , INTERP1
-    // 0x100 - 0x17c , SPINLOCKn
-    // lots more
-};
-inline auto& sio = *(SIO volatile*)(0xd0000000);
-
 template <uint8_t I> void initOutput(unsigned funcSel = GPIO::FuncSel<I>::SIO) {
     gpio[I].control.funcSel = funcSel;
     sio.gpioOutEnbSet = (1 << I);
@@ -149,13 +113,13 @@ template <uint8_t I> void initOutput(unsigned funcSel = GPIO::FuncSel<I>::SIO) {
         u->oeOver = GPIO::Override::kNormal;
     }
 
-    {
-        Update u {&padsBank0.gpio[I]};
-        u->drive = PadsBank0::Drive::k12mA;
-        u->inputEnable = false;
-        u->outputDisable = false;
-        u->isolation = false;
-    }
+    // (12mA is both `drive` bits set, so a single atomic set will do for that)
+    atomicSet(&padsBank0.gpio[I], [](auto& _) { _->drive = PadsBank0::Drive::k12mA; });
+    atomicClr(&padsBank0.gpio[I], [](auto& _) {
+        _->inputEnable = true;
+        _->outputDisable = true;
+        _->isolation = true;
+    });
 }
 
 template <uint8_t I> void initInput(unsigned funcSel = GPIO::FuncSel<I>::SIO) {
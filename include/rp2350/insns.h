@@ -4,6 +4,83 @@
 
 namespace rp2350 {
 
+#if defined(RP2350_HOST)
+
+// Host builds (see `rp2350/sim.h`) have no Arm instructions to issue.  Interrupt state
+// is simulated: `__wfi` and `__wfe` give the simulator a chance to run (e.g. to finish
+// DMA transfers and take pending IRQs), and `__ipsr` reports the IRQ being serviced.
+
+inline bool __hostIRQsEnabled = true;
+inline uint32_t __hostIPSR = 0;
+inline void (*__hostIdle)() = nullptr;
+
+[[gnu::always_inline]]
+inline void __nop() {
+    asm volatile("" : : : "memory");
+}
+
+[[gnu::always_inline]]
+inline void __breakpoint() {
+    __builtin_trap();
+}
+
+[[gnu::always_inline]]
+inline void __wfi() {
+    if (__hostIdle) { __hostIdle(); }
+}
+
+[[gnu::always_inline]]
+inline void __wfe() {
+    if (__hostIdle) { __hostIdle(); }
+}
+
+[[gnu::always_inline]]
+inline void __sev() {
+    asm volatile("" : : : "memory");
+}
+
+[[gnu::always_inline]]
+inline void __dmb() {
+    asm volatile("" : : : "memory");
+}
+
+[[gnu::always_inline]]
+inline void __dsb() {
+    asm volatile("" : : : "memory");
+}
+
+[[gnu::always_inline]]
+inline void __isb() {
+    asm volatile("" : : : "memory");
+}
+
+[[gnu::always_inline]]
+inline void __cpsid() {
+    __hostIRQsEnabled = false;
+}
+
+[[gnu::always_inline]]
+inline void __cpsie() {
+    __hostIRQsEnabled = true;
+}
+
+[[gnu::always_inline]]
+inline uint32_t __ipsr() {
+    return __hostIPSR;
+}
+
+[[gnu::always_inline]]
+inline uint32_t __primask() {
+    return __hostIRQsEnabled ? 0 : 1;
+}
+
+[[gnu::always_inline]]
+inline void __setPrimask(uint32_t x) {
+    __hostIRQsEnabled = !(x & 1);
+}
+
+#else
+
 [[gnu::always_inline]]
 inline void __nop() {
     asm volatile("nop" : : : "memory");
@@ -24,6 +101,29 @@ inline void __wfe() {
     asm volatile("wfe");
 }
 
+// Signal an event to both cores (ending a WFE on either)
+[[gnu::always_inline]]
+inline void __sev() {
+    asm volatile("sev" : : : "memory");
+}
+
+// Order memory accesses before this against those after it, as seen by other bus
+// masters (e.g. the other core), without waiting for them to complete as DSB does
+[[gnu::always_inline]]
+inline void __dmb() {
+    asm volatile("dmb" : : : "memory");
+}
+
+[[gnu::always_inline]]
+inline void __dsb() {
+    asm volatile("dsb" : : : "memory");
+}
+
+[[gnu::always_inline]]
+inline void __isb() {
+    asm volatile("isb" : : : "memory");
+}
+
 [[gnu::always_inline]]
 inline void __cpsid() {
     asm volatile("cpsid i");
@@ -41,6 +141,21 @@ inline uint32_t __ipsr() {
     return ret;
 }
 
+// PRIMASK bit 0 set: IRQs masked (as by `cpsid i`)
+[[gnu::always_inline]]
+inline uint32_t __primask() {
+    uint32_t ret;
+    asm volatile("mrs %0, primask" : "=r"(ret)::"memory");
+    return ret;
+}
+
+[[gnu::always_inline]]
+inline void __setPrimask(uint32_t x) {
+    asm volatile("msr primask, %0" : : "r"(x) : "memory");
+}
+
+#endif // RP2350_HOST
+
 inline void __disableIRQs() { __cpsid(); }
 inline void __enableIRQs() { __cpsie(); }
 
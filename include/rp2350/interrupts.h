@@ -5,6 +5,11 @@
 #include <rp2350/insns.h>
 #include <rp2350/m33.h>
 #include <rp2350/reset.h>
+#include <rp2350/sio.h>
+
+#if defined(RP2350_PROFILE)
+#include <rp2350/profile.h>
+#endif
 
 namespace rp2350 {
 
@@ -60,13 +65,15 @@ inline void pendingSV() {
 [[gnu::noinline]] [[gnu::retain]] [[gnu::used]] [[gnu::section(".systext")]]
 inline void sysTick() {
     // TODO: a 64-bit counter in hardware for sys time
+    // (With `RP2350_PROFILE` defined, the vector goes to `profileSysTick` instead.)
 }
 
 constexpr unsigned const kIRQHandlers = 52;
 
 inline vfunc irqHandlers[kIRQHandlers] {};
 
-[[gnu::noinline]] [[gnu::retain]] [[gnu::used]] [[gnu::section(".systext")]]
+// IRQ dispatch runs from SRAM, so that an XIP cache miss can't add to IRQ latency
+[[gnu::noinline]] [[gnu::retain]] [[gnu::used]] [[gnu::section(".time_critical")]]
 inline void irq() {
     auto intn = __currentInterrupt();
     if (intn >= 16 && intn < 16 + kIRQHandlers) {
@@ -76,8 +83,20 @@ inline void irq() {
     }
 }
 
+// The vector table (the M33 takes each exception through its slot here); `irqs` all go
+// through `irq` above by default.  Tables for VTOR must be aligned to a power of two
+// covering all the slots, i.e. 512 bytes.
+//
+// A table can also be built at compile time with handlers already in place, so that
+// they're dispatched directly from the moment IRQs are enabled, with nothing to set
+// up at run time:
+//
+//     [[gnu::section(".sysdata")]] constinit ARMVectors gVectors =
+//         ARMVectors {}.withIRQ(kDMAIRQ, dmaIRQ).withIRQ(33, uart0IRQ);
+//     ...
+//     useVectors(gVectors);
 struct [[gnu::aligned(512)]] ARMVectors {
-    void* resetSP = __stack + 1024;                // 0
+    void* resetSP = __stack + kStackWords;         // 0
     void (*reset)() = __reset;                     // 1
     void (*nmi)() = (::rp2350::nmi);               // 2
     void (*hardFault)() = (::rp2350::hardFault);   // 3
@@ -92,7 +111,11 @@ struct [[gnu::aligned(512)]] ARMVectors {
     void (*debugMon)() = (::rp2350::debugMon);     // 12
     void (*_unknown0B)() = (nullptr);              // 13
     void (*pendingSV)() = (::rp2350::pendingSV);   // 14
+#if defined(RP2350_PROFILE)
+    void (*sysTick)() = (::rp2350::profileSysTick); // 15; see `profile.h`
+#else
     void (*sysTick)() = (::rp2350::sysTick);       // 15
+#endif
     void (*irqs[52])() = {
         // 16 through 67
         ::rp2350::irq, ::rp2350::irq, ::rp2350::irq, ::rp2350::irq, ::rp2350::irq,
@@ -107,13 +130,54 @@ struct [[gnu::aligned(512)]] ARMVectors {
         ::rp2350::irq, ::rp2350::irq, ::rp2350::irq, ::rp2350::irq, ::rp2350::irq,
         ::rp2350::irq, ::rp2350::irq,
     };
+
+    // This table, with IRQ `irq` going straight to `fn`
+    constexpr ARMVectors withIRQ(unsigned irq, vfunc fn) const {
+        auto ret = *this;
+        ret.irqs[irq] = fn;
+        return ret;
+    }
 };
 
+// The default table, in SRAM (`.sysdata` is copied there from flash at reset), so
+// that vector fetches don't wait on the XIP cache and `setHandler` can write to it
 [[gnu::retain]] [[gnu::used]] [[gnu::section(".sysdata")]]
-inline ARMVectors __vectorTable;
+constinit inline ARMVectors __vectorTable;
+
+// Each core's table in VTOR, by `coreNum`.  `launchCore1` gives core 1 a copy of the
+// launching core's, so from then on each core's handlers are its own.
+inline ARMVectors* coreVectors[2] {&__vectorTable, &__vectorTable};
+
+// This core's table
+inline ARMVectors& activeVectors() { return *coreVectors[coreNum()]; }
+
+// Point this core's VTOR at `table`, which must be in SRAM (see `ARMVectors`), and use
+// it from now on for this core's `setHandler`s, and as the table to copy for core 1
+inline void useVectors(ARMVectors& table) {
+    coreVectors[coreNum()] = &table;
+    __dsb();
+    m33.vtor().u32() = uint32_t(uintptr_t(&table));
+    __dsb();
+    __isb();
+}
+
+// Send IRQ `irq` directly to `fn`, through its vector table slot, on this core only
+// (core 1 starts with whatever core 0's table held at `launchCore1`).  This skips
+// `irq` above: the IPSR read, the range check, the call through `irqHandlers` and the
+// clear-pending write after it, so `fn` must itself quiet whatever raised the IRQ (as
+// handlers do anyway).  Put `fn` in `.time_critical` to keep flash out of the path as
+// well.  `clearHandler` puts the slot back to `irq`.
+inline void setHandler(unsigned irq, vfunc fn) {
+    activeVectors().irqs[irq] = fn;
+    __dsb(); // (the next exception entry fetches the new vector)
+    __isb();
+}
+
+inline void clearHandler(unsigned irq) { setHandler(irq, ::rp2350::irq); }
 
 [[gnu::noinline]] [[gnu::retain]] [[gnu::used]] [[gnu::section(".systext")]]
 inline void initInterrupts() {
+    useVectors(activeVectors());
     __enableIRQs();
 }
 
@@ -52,8 +52,12 @@ struct M33 {
         unsigned v;
     };
     struct SCR : R32 {
-        // TODO
-        unsigned v;
+        unsigned             : 1;
+        unsigned sleepOnExit : 1; // 1
+        unsigned sleepDeep   : 1; // 2
+        unsigned sleepDeepS  : 1; // 3
+        unsigned sevOnPend   : 1; // 4: pending interrupts (even disabled ones) wake WFE
+        unsigned             : 27;
     };
 
     struct CCR : R32 {
@@ -115,6 +119,11 @@ struct M33 {
     ACTLR&    actlr() { return *(ACTLR   *)(&regs[0xe008 >> 2]); }  // Auxiliary Control Register
     CSR&      csr()   { return *(CSR     *)(&regs[0xe010 >> 2]); }  // SysTick Control and Status Register
     uint32_t& rvr()   { return *(uint32_t*)(&regs[0xe014 >> 2]); }  // SysTick Reload Value Register
+    uint32_t& cvr()   { return *(uint32_t*)(&regs[0xe018 >> 2]); }  // SysTick Current Value Register
+
+    uint32_t& dwtCtrl()   { return *(uint32_t*)(&regs[0x1000 >> 2]); }  // DWT Control Register
+    uint32_t& dwtCycCnt() { return *(uint32_t*)(&regs[0x1004 >> 2]); }  // DWT Cycle Count Register
+    uint32_t& demcr()     { return *(uint32_t*)(&regs[0xedfc >> 2]); }  // Debug Exception and Monitor Control Register
 
     uint32_t* ser_()  { return regs + (0xe100 >> 2); }  // Interrupt (0..31) Set Enable Registers
     uint32_t* cer_()  { return regs + (0xe180 >> 2); }  // Interrupt (0..31) Clear Enable Registers
@@ -149,13 +158,26 @@ struct M33 {
     void disableIRQ(unsigned irq) { cer(irq >> 5) = uint32_t(1) << (irq & 31); };
     void triggerIRQ(unsigned irq) { spr(irq >> 5) = uint32_t(1) << (irq & 31); };
     void clrPendIRQ(unsigned irq) { cpr(irq >> 5) = uint32_t(1) << (irq & 31); };
+
+    // DWT cycle counter (CYCCNT): counts processor clock cycles, wrapping every 2^32.
+    // Starting it needs trace enabled in DEMCR first.
+    void startCycleCounter() {
+        demcr() |= (1u << 24); // TRCENA
+        dwtCycCnt() = 0;
+        dwtCtrl() |= 1; // CYCCNTENA
+    }
+
+    // (A volatile read, so that two reads around some work can't be merged)
+    uint32_t cycles() { return *(uint32_t volatile*)&dwtCycCnt(); }
 };
 inline auto& m33 = *(M33*)(0xe0000000);
 
 [[gnu::noinline]] [[gnu::retain]] [[gnu::used]] [[gnu::section(".systext")]]
 inline void initCPUBasic() {
-    m33.ccr().unalignedTrap = true;
-    m33.ccr().div0Trap = true;
+    update(&m33.ccr(), [](auto& _) {
+        _->unalignedTrap = true;
+        _->div0Trap = true;
+    });
 }
 
 } // namespace rp2350
\ No newline at end of file
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <platform.h>
+#include <rp2350/insns.h>
+#include <rp2350/interrupts.h>
+#include <rp2350/m33.h>
+#include <rp2350/multicore.h>
+#include <rp2350/sio.h>
+
+namespace rp2350 {
+
+// Messages and signals between the two cores.
+//
+// `Mailbox<T>` sends word-sized values (pointers, indices, small PODs) through the
+// inter-core FIFOs (3.1.5): a send is a DMB, a store and an SEV, and a receive a load,
+// so a message costs a handful of cycles each way.  The FIFOs are only four words deep,
+// so larger payloads go by pointer: allocate a block from a `Pool` (which is safe to
+// share between the cores), fill it, and send the pointer; the other core frees it
+// when done.  Nothing is copied, and the DMB before each send makes the block's
+// contents visible to the other core before the pointer is.
+//
+//     struct Frame { ... };
+//     Pool<Frame, 8> gFrames;
+//     constinit Mailbox<Frame*> gFrameBox;
+//
+//     // core 0                            // core 1
+//     auto* f = gFrames.make();            Frame* f;
+//     fill(*f);                            if (gFrameBox.tryRecv(f)) {
+//     if (!gFrameBox.trySend(f)) {             consume(*f);
+//         gFrames.destroy(f); // (dropped)     gFrames.destroy(f);
+//     }                                    }
+//
+// Each core receives what the other sends, so one `Mailbox` object serves both
+// directions; its counts are kept per core.  There's only one FIFO each way, though,
+// so a program uses either this or `dispatch`/`core1Worker`, not both.
+//
+// To be interrupted on arrival instead of polling, `enableMailboxIRQ`: SIO_IRQ_FIFO
+// stays raised while anything is waiting, so its handler must drain the FIFO.
+//
+// Doorbells (3.1.6) are the cheaper path for signals carrying no data: `ringDoorbell`
+// sets bits which raise SIO_IRQ_BELL on the other core until it `takeDoorbells`.
+// Repeated rings before that merge into one.
+
+constexpr static unsigned kIRQSIOBell = 26; // p.84: SIO_IRQ_BELL
+
+// How a `T` travels as a FIFO word
+template <class T> struct MailWord {
+    static_assert(sizeof(T) == sizeof(uint32_t) && __is_trivially_copyable(T));
+    static uint32_t to(T x) { return __builtin_bit_cast(uint32_t, x); }
+    static T from(uint32_t w) { return __builtin_bit_cast(T, w); }
+};
+
+template <class T> struct MailWord<T*> {
+    static uint32_t to(T* p) { return uint32_t(uintptr_t(p)); }
+    static T* from(uint32_t w) { return (T*)uintptr_t(w); }
+};
+
+template <class T> struct Mailbox {
+    using Word = MailWord<T>;
+
+    // Indexed by the core doing the counting
+    uint32_t sent_[2] {};     // messages sent
+    uint32_t received_[2] {}; // messages received
+    uint32_t full_[2] {};     // sends refused (or, for `send`, delayed) by a full FIFO
+
+    // Send `x` if there's room; false if the FIFO is full
+    bool trySend(T x) {
+        auto core = coreNum();
+        if (!fifoCanPush()) {
+            ++full_[core];
+            return false;
+        }
+        __dmb();
+        sio.fifoWrite = Word::to(x);
+        __sev();
+        ++sent_[core];
+        return true;
+    }
+
+    // Send `x`, waiting for room if need be
+    void send(T x) {
+        auto core = coreNum();
+        if (!fifoCanPush()) { ++full_[core]; }
+        fifoPush(Word::to(x));
+        ++sent_[core];
+    }
+
+    // Send as many of `xs[0, n)` as there's room for, in order, with one DMB and one
+    // SEV for the lot; returns how many went
+    unsigned sendSome(T const* xs, unsigned n) {
+        auto core = coreNum();
+        unsigned i = 0;
+        if (n) { __dmb(); }
+        while (i < n && fifoCanPush()) { sio.fifoWrite = Word::to(xs[i++]); }
+        if (i) { __sev(); }
+        if (i < n) { ++full_[core]; }
+        sent_[core] += i;
+        return i;
+    }
+
+    // Take the next message if there is one
+    bool tryRecv(T& x) {
+        if (!fifoCanPop()) { return false; }
+        x = Word::from(sio.fifoRead);
+        __dmb();
+        ++received_[coreNum()];
+        return true;
+    }
+
+    // Take the next message, waiting (in WFE) for one if need be
+    T recv() {
+        auto x = Word::from(fifoPop());
+        ++received_[coreNum()];
+        return x;
+    }
+
+    // Take up to `n` waiting messages into `xs`, with one DMB for the lot; returns
+    // how many
+    unsigned recvSome(T* xs, unsigned n) {
+        unsigned i = 0;
+        while (i < n && fifoCanPop()) { xs[i++] = Word::from(sio.fifoRead); }
+        if (i) { __dmb(); }
+        received_[coreNum()] += i;
+        return i;
+    }
+};
+
+// Call `handler` on this core whenever messages arrive.  Both cores share
+// `irqHandlers`, so if both enable this, they share the handler too (it runs on
+// whichever core took the IRQ, and sees that core's FIFO).
+inline void enableMailboxIRQ(vfunc handler) {
+    irqHandlers[kIRQSIOFIFO] = handler;
+    sio.fifoStatus = SIO::kFIFOWOF | SIO::kFIFOROE; // (these hold the IRQ up, too)
+    m33.enableIRQ(kIRQSIOFIFO);
+}
+
+inline void disableMailboxIRQ() { m33.disableIRQ(kIRQSIOFIFO); }
+
+// Raise SIO_IRQ_BELL on the other core, with doorbell `bits` (8 of them) set.  The
+// DMB makes earlier writes visible there first.
+inline void ringDoorbell(uint32_t bits) {
+    __dmb();
+    sio.doorbellOutSet = bits;
+}
+
+// The doorbells rung at this core since last taken, which are then cleared (and the
+// IRQ with them)
+inline uint32_t takeDoorbells() {
+    uint32_t bits = sio.doorbellInSet;
+    sio.doorbellInClr = bits;
+    __dmb();
+    return bits;
+}
+
+// Call `handler` on this core when the other rings; it should `takeDoorbells`
+inline void enableDoorbellIRQ(vfunc handler) {
+    irqHandlers[kIRQSIOBell] = handler;
+    m33.enableIRQ(kIRQSIOBell);
+}
+
+inline void disableDoorbellIRQ() { m33.disableIRQ(kIRQSIOBell); }
+
+} // namespace rp2350
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <platform.h>
+#include <rp2350/common.h>
+#include <rp2350/insns.h>
+#include <rp2350/interrupts.h>
+#include <rp2350/m33.h>
+#include <rp2350/psm.h>
+#include <rp2350/sio.h>
+#include <rp2350/tls.h>
+
+#if !defined(RP2350_CORE1_STACK_WORDS)
+#define RP2350_CORE1_STACK_WORDS 512
+#endif
+
+namespace rp2350 {
+
+// The second core.
+//
+// After reset, core 1 sits in the bootrom waiting for core 0 to send it, over the
+// inter-core FIFO, a vector table, a stack pointer and an entry point (5.3, "Launching
+// Code On Processor Core 1").  `launchCore1(fn)` does that handshake, starting `fn` on
+// a stack of its own in SCRATCH_Y (SRAM9, so its pushes and pops don't compete with
+// core 0's for a bank), its own `thread_local`s (`tls.h`), and its own vector table: a
+// copy of the launching core's, so that `setHandler` on either core leaves the other's
+// alone.  Core 1 has its own NVIC, so enable whatever IRQs it's to take from core 1
+// itself; those left going through `irq` find their handlers in the shared
+// `irqHandlers`.
+//
+// For offloading work, `launchCore1(core1Worker)` starts a loop on core 1 which runs
+// `Job`s sent with `dispatch`, one at a time in order.
+
+constexpr static unsigned kIRQSIOFIFO = 25; // p.84: SIO_IRQ_FIFO
+
+constexpr unsigned kCore1StackWords = RP2350_CORE1_STACK_WORDS;
+[[gnu::section(".scratch_y.core1_stack")]]
+alignas(8) inline uint32_t __core1Stack[kCore1StackWords];
+
+// Room for core 1's vector table, filled in by `launchCore1` (in `.bss`, as VTOR needs
+// SRAM, and there's nothing to load from flash)
+alignas(ARMVectors) inline uint8_t __core1Vectors[sizeof(ARMVectors)];
+
+// This core's ends of the inter-core FIFOs (3.1.5); four words deep each way.  Each
+// push is preceded by a DMB so that data the word refers to is visible to the other
+// core first, and followed by a SEV to wake it from a WFE in `fifoPop`.
+
+inline bool fifoCanPush() { return sio.fifoStatus & SIO::kFIFOReady; }
+inline bool fifoCanPop() { return sio.fifoStatus & SIO::kFIFOValid; }
+
+inline void fifoPush(uint32_t x) {
+    while (!fifoCanPush()) { __nop(); }
+    __dmb();
+    sio.fifoWrite = x;
+    __sev();
+}
+
+inline uint32_t fifoPop() {
+    while (!fifoCanPop()) { __wfe(); }
+    uint32_t x = sio.fifoRead;
+    __dmb();
+    return x;
+}
+
+inline void fifoDrain() {
+    while (fifoCanPop()) { (void)sio.fifoRead; }
+}
+
+// Hold core 1 in reset, then let it back into the bootrom, which says so with a 0
+inline void resetCore1() {
+    auto bit = uint32_t(PSM::Bit::PROC1);
+    atomicSet(&psm.frceOff, bit);
+    while (!(*(uint32_t volatile*)&psm.frceOff & bit)) { __nop(); }
+    atomicClr(&psm.frceOff, bit);
+    (void)fifoPop();
+}
+
+inline vfunc core1Fn;
+
+[[noreturn]] inline void __core1Entry() {
+    initTLS(1);
+    core1Fn();
+    while (true) { __wfe(); }
+}
+
+// Start `fn` on core 1, which must be waiting in the bootrom (as after reset, or
+// `resetCore1`).  If `fn` returns, core 1 idles in WFE.
+[[gnu::noinline]] [[gnu::retain]] [[gnu::used]] [[gnu::section(".systext")]]
+inline void launchCore1(vfunc fn) {
+    core1Fn = fn;
+    // (Seen by core 1 before its address is, through `fifoPush`'s DMB)
+    auto* vectors = new (__core1Vectors) ARMVectors(activeVectors());
+    coreVectors[1] = vectors;
+
+    // Our own FIFO IRQ handler mustn't eat the bootrom's replies
+    bool fifoIRQ = m33.ser(kIRQSIOFIFO >> 5) & (1u << (kIRQSIOFIFO & 31));
+    m33.disableIRQ(kIRQSIOFIFO);
+
+    // Each word is echoed back; on a mismatch, start over.  The zeroes resync the
+    // bootrom with us, whatever state its FIFO was left in.
+    uint32_t const cmds[] {
+        0,
+        0,
+        1,
+        uint32_t(uintptr_t(vectors)),
+        uint32_t(uintptr_t(__core1Stack + kCore1StackWords)),
+        uint32_t(uintptr_t(__core1Entry)),
+    };
+    unsigned i = 0;
+    while (i < sizeof(cmds) / sizeof(cmds[0])) {
+        auto cmd = cmds[i];
+        if (!cmd) {
+            fifoDrain();
+            __sev(); // (the bootrom waits in WFE)
+        }
+        fifoPush(cmd);
+        i = (fifoPop() == cmd) ? i + 1 : 0;
+    }
+
+    if (fifoIRQ) { m33.enableIRQ(kIRQSIOFIFO); }
+}
+
+// A function call to run on core 1; see `dispatch`.  Keep it alive (and don't reuse
+// it) until `done`.
+struct Job {
+    void (*fn_)(void*);
+    void* arg_ {};
+    uint32_t done_ {};
+
+    bool done() const { return __atomic_load_n(&done_, __ATOMIC_ACQUIRE); }
+
+    void wait() const {
+        while (!done()) { __wfe(); }
+    }
+};
+
+// Queue `job` for `core1Worker`; blocks only while the FIFO is full
+inline void dispatch(Job& job) {
+    __atomic_store_n(&job.done_, 0, __ATOMIC_RELAXED);
+    fifoPush(uint32_t(uintptr_t(&job)));
+}
+
+// Core 1's loop for `dispatch`ed jobs; launch with `launchCore1(core1Worker)`
+[[noreturn]] inline void core1Worker() {
+    while (true) {
+        auto* job = (Job*)uintptr_t(fifoPop());
+        job->fn_(job->arg_);
+        __atomic_store_n(&job->done_, 1, __ATOMIC_RELEASE);
+        __sev();
+    }
+}
+
+// Run `fn(arg0)` here and `fn(arg1)` on core 1 (via `core1Worker`) at the same time,
+// e.g. each rendering half of a frame; returns once both are done
+inline void runOnBoth(void (*fn)(void*), void* arg0, void* arg1) {
+    Job job {.fn_ = fn, .arg_ = arg1};
+    dispatch(job);
+    fn(arg0);
+    job.wait();
+}
+
+} // namespace rp2350
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <platform.h>
+#include <rp2350/insns.h>
+#include <rp2350/sio.h>
+
+namespace rp2350 {
+
+// Locks between cores, and between thread code and ISRs.
+//
+// `Mutex` is one of the SIO hardware spinlocks (3.1.4): reading the lock's register
+// claims it, in a single bus access (a few cycles when uncontended), and writing it
+// frees it.  It spins rather than sleeps, and isn't recursive; hold it briefly.
+//
+// RP2350-E2: writes to SIO registers at 0x180-0x1fc also land on the spinlock 0x80
+// below, freeing it.  Spinlocks 0-15 are under the doorbell, MTIME etc. registers,
+// which do get written (e.g. to ring doorbells), so only 16-31 are used here; they
+// sit under the SIO TMDS encoder, which we don't use.
+//
+// Taking a `Mutex` in thread code which an ISR on the same core may also take would
+// deadlock if the ISR arrived in between; use `CriticalSection` there, which masks
+// IRQs on this core first:
+//
+//     constinit Mutex gQueueLock {kFirstSpinLock};
+//
+//     void push(...) {
+//         CriticalSection _ {gQueueLock};
+//         ...
+//     }
+
+constexpr static unsigned kFirstSpinLock = 16; // (RP2350-E2; see above)
+constexpr static unsigned kSpinLocks = 32;
+
+struct Mutex {
+    unsigned id_;
+    uint32_t acquired_ {};  // times locked
+    uint32_t contended_ {}; // of those, times it was held by someone else at first
+    uint32_t spins_ {};     // failed attempts to claim, in all
+
+    constexpr explicit Mutex(unsigned id) : id_(id) {
+        if (id < kFirstSpinLock || id >= kSpinLocks) { __abort(); }
+    }
+
+    bool tryLock() {
+        if (!sio.spinlock[id_]) { return false; }
+        __dmb(); // accesses in the locked region stay in it
+        ++acquired_;
+        return true;
+    }
+
+    void lock() {
+        uint32_t spins = 0;
+        while (!sio.spinlock[id_]) { ++spins; }
+        __dmb();
+        // (Counted while we hold the lock, so these need nothing more)
+        ++acquired_;
+        if (spins) {
+            ++contended_;
+            spins_ += spins;
+        }
+    }
+
+    void unlock() {
+        __dmb();
+        sio.spinlock[id_] = 1;
+    }
+
+    void resetCounts() {
+        lock();
+        acquired_ = contended_ = spins_ = 0;
+        unlock();
+    }
+};
+
+// Holds any lock (something with `lock` and `unlock`) for its lifetime
+template <class L> struct LockGuard {
+    L& lock_;
+
+    [[gnu::always_inline]] explicit LockGuard(L& lock) : lock_(lock) { lock_.lock(); }
+    [[gnu::always_inline]] ~LockGuard() { lock_.unlock(); }
+
+    LockGuard(LockGuard const&) = delete;
+    LockGuard& operator=(LockGuard const&) = delete;
+};
+
+// A `Mutex` which also masks IRQs on this core while held, so ISRs and thread code on
+// either core can share it; `CriticalSection` as an object with `lock` and `unlock`,
+// for code taking any kind of lock (e.g. `MpmcQueue`).  The saved PRIMASK is only
+// touched by the holder.
+struct IRQMutex {
+    Mutex mutex_;
+    uint32_t primask_ {};
+
+    constexpr explicit IRQMutex(unsigned id) : mutex_(id) {}
+
+    void lock() {
+        auto primask = __primask();
+        __cpsid();
+        mutex_.lock();
+        primask_ = primask;
+    }
+
+    void unlock() {
+        auto primask = primask_;
+        mutex_.unlock();
+        __setPrimask(primask);
+    }
+};
+
+// Masks IRQs on this core for its lifetime, restoring PRIMASK as it was (so these
+// nest), and optionally holds a `Mutex` too, for data shared with the other core.
+struct CriticalSection {
+    uint32_t primask_;
+    Mutex* mutex_ {};
+
+    [[gnu::always_inline]] CriticalSection() : primask_(__primask()) { __cpsid(); }
+
+    [[gnu::always_inline]] explicit CriticalSection(Mutex& mutex)
+            : primask_(__primask()), mutex_(&mutex) {
+        __cpsid();
+        mutex_->lock();
+    }
+
+    [[gnu::always_inline]] ~CriticalSection() {
+        if (mutex_) { mutex_->unlock(); }
+        __setPrimask(primask_);
+    }
+
+    CriticalSection(CriticalSection const&) = delete;
+    CriticalSection& operator=(CriticalSection const&) = delete;
+};
+
+} // namespace rp2350
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <format.h>
+#include <platform.h>
+#include <rp2350/common.h>
+#include <rp2350/m33.h>
+
+#if !defined(RP2350_PROFILE_SLOTS)
+#define RP2350_PROFILE_SLOTS 512
+#endif
+
+namespace rp2350 {
+
+// Statistical profiler: SysTick periodically samples the interrupted PC.
+//
+// Build with `-DRP2350_PROFILE` to point the SysTick vector (in `ARMVectors`) at
+// `profileSysTick`.  Then call `profileStart()`, run the workload, and write out the
+// results with `profileDump`, e.g.:
+//
+//     profileDump([](char const* s) { uart0.write(s); });
+//
+// `misc/profile.py` turns a capture of that output plus the ELF into a flat profile.
+//
+// Samples are counted per distinct (PC, LR) pair in a fixed table in SRAM.  LR is kept
+// so that time in leaf functions, which may never touch the stack, can be charged to
+// their callers; in non-leaf code it's only whatever the last call left there.  Once
+// the table is full, samples with new pairs are only counted as `dropped`.
+
+struct Profile {
+    constexpr static unsigned kSlots = RP2350_PROFILE_SLOTS;
+    constexpr static unsigned kProbes = 8;
+    static_assert(kSlots >= 2 * kProbes && !(kSlots & (kSlots - 1)));
+
+    struct Slot {
+        uint32_t pc;
+        uint32_t lr;
+        uint32_t count; // 0 if unused
+    };
+
+    Slot slots_[kSlots];
+    uint32_t samples_;
+    uint32_t dropped_;
+    uint32_t periodUs_;
+    bool running_;
+
+    // From SysTick only; linear probing from a multiplicative hash of the pair
+    void record(uint32_t pc, uint32_t lr) {
+        auto h = ((pc ^ (lr << 7)) * 0x9e3779b1u) >> 16;
+        ++samples_;
+        for (unsigned n = 0; n < kProbes; n++) {
+            auto& slot = slots_[(h + n) & (kSlots - 1)];
+            if (!slot.count) {
+                slot = {.pc = pc, .lr = lr, .count = 1};
+                return;
+            }
+            if (slot.pc == pc && slot.lr == lr) {
+                ++slot.count;
+                return;
+            }
+        }
+        ++dropped_;
+    }
+};
+
+inline Profile profile;
+
+extern "C" {
+
+// `frame` is the exception frame SysTick stacked: r0-r3, r12, lr, pc, xpsr
+[[gnu::noinline]] [[gnu::retain]] [[gnu::used]] [[gnu::section(".time_critical")]]
+inline void __profileSample(uint32_t const* frame) {
+    if (__atomic_load_n(&profile.running_, __ATOMIC_RELAXED)) {
+        profile.record(frame[6], frame[5]);
+    }
+}
+
+} // extern "C"
+
+// SysTick handler for profiling.  Finds the exception frame on whichever stack was in
+// use when SysTick fired (EXC_RETURN bit 2; 0 for MSP) and hands it to the above.
+[[gnu::naked]] [[gnu::noinline]] [[gnu::retain]] [[gnu::used]]
+[[gnu::section(".time_critical")]]
+inline void profileSysTick() {
+#if defined(__arm__)
+    asm volatile("tst lr, #4\n"
+                 "ite eq\n"
+                 "mrseq r0, msp\n"
+                 "mrsne r0, psp\n"
+                 "b __profileSample\n");
+#endif
+}
+
+// Clear the profile, and start sampling every `periodUs` microseconds of the 1MHz
+// SysTick reference clock (see `initSystemTicks`).  The default period is prime, so
+// sampling doesn't fall into step with periodic work such as a 1ms loop.
+inline void profileStart(uint32_t periodUs = 997) {
+    __atomic_store_n(&profile.running_, false, __ATOMIC_RELAXED);
+    __aeabi_memclr4(profile.slots_, sizeof(profile.slots_));
+    profile.samples_ = 0;
+    profile.dropped_ = 0;
+    profile.periodUs_ = periodUs;
+    m33.rvr() = periodUs - 1;
+    m33.cvr() = 0;
+    update(&m33.csr(), [](auto& _) {
+        _->enable = 1;
+        _->tickInt = 1;
+        _->source = unsigned(M33::ClockSource::EXT_REF_CLK);
+    });
+    __atomic_store_n(&profile.running_, true, __ATOMIC_RELEASE);
+}
+
+inline void profileStop() {
+    __atomic_store_n(&profile.running_, false, __ATOMIC_RELAXED);
+}
+
+// Text for `misc/profile.py`: a header, then "pc lr count" per used slot (addresses in
+// hex, count in decimal), then an end marker.  Each line is passed to `write`.
+template <class W> void profileDump(W write) {
+    bool wasRunning = __atomic_exchange_n(&profile.running_, false, __ATOMIC_ACQUIRE);
+    char line[80];
+    auto append = [](char* p, char const* s) {
+        while (*s) { *p++ = *s++; }
+        return p;
+    };
+    auto* p = append(line, "# profile samples=");
+    p = formatDec(p, profile.samples_);
+    p = append(p, " dropped=");
+    p = formatDec(p, profile.dropped_);
+    p = append(p, " period_us=");
+    p = formatDec(p, profile.periodUs_);
+    *p++ = '\n';
+    *p = 0;
+    write((char const*)line);
+    for (auto const& slot : profile.slots_) {
+        if (!slot.count) { continue; }
+        p = formatHex(line, slot.pc);
+        *p++ = ' ';
+        p = formatHex(p, slot.lr);
+        *p++ = ' ';
+        p = formatDec(p, slot.count);
+        *p++ = '\n';
+        *p = 0;
+        write((char const*)line);
+    }
+    write("# profile end\n");
+    __atomic_store_n(&profile.running_, wasRunning, __ATOMIC_RELEASE);
+}
+
+} // namespace rp2350
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <platform.h>
+#include <rp2350/common.h>
+
+namespace rp2350 {
+
+// 7.4. Power-on State Machine: forces power domains' resets on / off
+struct PSM {
+    // Bit per domain, as in every register here
+    enum class Bit : uint32_t {
+        PROC0 = 1u << 23,
+        PROC1 = 1u << 24,
+    };
+
+    uint32_t frceOn;  // 0x00
+    uint32_t frceOff; // 0x04
+    uint32_t wdSel;   // 0x08
+    uint32_t done;    // 0x0c
+};
+inline auto& psm = *(PSM*)(0x40018000);
+
+} // namespace rp2350
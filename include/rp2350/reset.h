@@ -1,9 +1,48 @@
 #pragma once
 
+#include <format.h>
 #include <platform.h>
 #include <rp2350/common.h>
 #include <rp2350/insns.h>
 #include <rp2350/m33.h>
+#include <rp2350/tls.h>
+
+namespace rp2350 {
+
+// Boot-phase timestamps recorded by `__reset`, in `clk_sys` cycles (DWT CYCCNT) since
+// reset entry.  Note that `clk_sys` is still running from the bootrom's clock setup at
+// this point, i.e. before any `initSystemClock`.
+struct BootTimes {
+    uint32_t bssCleared;
+    uint32_t dataCopied;
+    uint32_t started; // just before calling `__start`
+};
+inline BootTimes bootTimes;
+
+// `bootTimes` as one line of cycles spent in each phase, then in all, e.g.
+// "boot  bss=1210 data=388 init=96 total=1694", passed as a string to `write` (as with
+// `dumpCycles`)
+template <class W> void dumpBootTimes(W write) {
+    auto const& t = bootTimes;
+    char line[80];
+    auto* p = line;
+    auto append = [&](char const* s) {
+        while (*s) { *p++ = *s++; }
+    };
+    append("boot  bss=");
+    p = formatDec(p, t.bssCleared);
+    append(" data=");
+    p = formatDec(p, t.dataCopied - t.bssCleared);
+    append(" init=");
+    p = formatDec(p, t.started - t.dataCopied);
+    append(" total=");
+    p = formatDec(p, t.started);
+    *p++ = '\n';
+    *p = 0;
+    write((char const*)line);
+}
+
+} // namespace rp2350
 
 extern "C" {
 
@@ -12,23 +51,49 @@ constexpr unsigned kStackWords = 256;
 
 [[gnu::noinline]] [[gnu::retain]] [[gnu::used]] [[gnu::section(".systext")]]
 inline void __reset() {
-    void* sram = &__sram_begin;
-    auto size = unsigned(__stack) - unsigned(sram);
-    __builtin_memset(sram, 0, size);
-    sram = __stack + kStackWords;
-    size = unsigned(&__sram_end) - unsigned(sram);
-    __builtin_memset(sram, 0, size);
+    using rp2350::m33;
+
+    // Start the cycle counter for the boot timestamps
+    m33.startCycleCounter();
+
+    // Zero only `.bss`, stepping around the stack we're running on (which also lives
+    // in `.bss`).  The rest of SRAM is left as-is, unless `RP2350_RESET_CLEARS_HEAP`
+    // is defined.
+    auto* bss = (uint8_t*)&__bss_begin;
+    auto* stack = (uint8_t*)__stack;
+    auto* stackEnd = (uint8_t*)(__stack + kStackWords);
+    __builtin_memset(bss, 0, unsigned(stack - bss));
+    __builtin_memset(stackEnd, 0, unsigned((uint8_t*)&__bss_end - stackEnd));
+#if defined(RP2350_RESET_CLEARS_HEAP)
+    __builtin_memset(&__heap, 0, uintptr_t(&__heap_end) - uintptr_t(&__heap));
+#endif
+    uint32_t bssCleared = m33.cycles();
+
+    // Code in `.time_critical` runs from SRAM; bring it in from flash.  Both copies
+    // below are word copies, as `layout.ld` word-aligns these sections' addresses.
+    auto* hotFlash = &__time_critical_flash_begin;
+    auto* hotSRAM = &__time_critical_sram_begin;
+    auto hotSize = uintptr_t(&__time_critical_sram_end) - uintptr_t(hotSRAM);
+    __aeabi_memcpy4(hotSRAM, hotFlash, hotSize);
+    rp2350::__dsb();
+    rp2350::__isb();
 
     auto* dataFlash = &__data_flash_begin;
     auto* dataSRAM = &__data_sram_begin;
-    auto dataSize = unsigned(&__data_sram_end) - unsigned(dataSRAM);
-    __builtin_memcpy(dataSRAM, dataFlash, dataSize);
+    auto dataSize = uintptr_t(&__data_sram_end) - uintptr_t(dataSRAM);
+    __aeabi_memcpy4(dataSRAM, dataFlash, dataSize);
+    rp2350::initTLS(0); // (before static initializers, which may use it)
+    uint32_t dataCopied = m33.cycles();
 
     // Run static initializers
     auto* init = reinterpret_cast<vfunc*>(&__init_array_begin);
     auto* initEnd = reinterpret_cast<vfunc*>(&__init_array_end);
     for (; init < initEnd; ++init) { (**init)(); }
 
+    // (Written only now, as `bootTimes` is itself in `.bss`)
+    rp2350::bootTimes = {
+        .bssCleared = bssCleared, .dataCopied = dataCopied, .started = m33.cycles()};
+
     // Call user's entry function
     ::__start();
 }
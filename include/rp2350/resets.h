@@ -1,6 +1,7 @@
 #pragma once
 
 #include <platform.h>
+#include <rp2350/common.h>
 #include <rp2350/insns.h>
 
 namespace rp2350 {
@@ -76,15 +77,12 @@ struct Resets {
     uint32_t wdSel;     // 0x40020004
     uint32_t resetDone; // 0x40020008
 
-    void reset(Bit _bit) {
-        uint32_t bits = uint32_t(_bit);
-        resets |= bits;
-    }
+    void reset(Bit _bit) { atomicSet(&resets, uint32_t(_bit)); }
 
     void unreset(Bit _bit, bool wait = true) {
         uint32_t bits = uint32_t(_bit);
         if ((resets & bits) || (resetDone & bits) != bits) {
-            resets &= ~bits;
+            atomicClr(&resets, bits);
             while (wait && ((resetDone & bits) != bits)) { __nop(); }
         }
     }
@@ -132,9 +130,10 @@ inline void initResets() {
     ;
     // clang-format on
 
-    resets.resets |= kMask;
-    // Some components seem to need a little bit of time before un-reset.
-    for (unsigned i = 0; i < 1000000; i++) { __nop(); }
+    atomicSet(&resets.resets, kMask);
+    // Wait until every one of these blocks reports that it's actually in reset (its
+    // `resetDone` bit drops), rather than spinning for a fixed, worst-case time.
+    while (resets.resetDone & kMask) { __nop(); }
 }
 
 } // namespace rp2350
@@ -0,0 +1,690 @@
+#pragma once
+
+#include <platform.h>
+
+#if !defined(RP2350_HOST)
+#error "rp2350/sim.h is only for host builds (-DRP2350_HOST -m32); see `make sim`"
+#endif
+
+#include <rp2350/common.h>
+#include <rp2350/insns.h>
+#include <rp2350/interrupts.h>
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+
+// Host-side simulation of the RP2350's peripheral address space, so that drivers,
+// init sequences and ISRs can run (and be measured) on a Linux / x86 box.
+//
+// The register headers are used unchanged: `inline auto& dma = *(DMA*)(0x50000000)`
+// still points at 0x50000000.  `sim.start()` maps the peripheral ranges there, with no
+// access allowed.  Each access then faults; the SIGSEGV handler gives the page the
+// register values (asking the owning `Model` for the value being read), makes it
+// accessible, and single-steps the instruction (x86 trap flag).  The SIGTRAP which
+// follows hands any written words to the model and locks the page again.  Writes to
+// the atomic XOR / SET / CLR aliases (2.1.3) are resolved before the model sees them.
+//
+// Every access is counted against its model (or as "unmodelled"); `sim.dump()` prints
+// the counts.  Note a read-modify-write instruction (e.g. x86 `orl $1, (%eax)`) counts
+// as one write.
+//
+// Build with `-m32 -DRP2350_HOST`: ILP32 keeps register layouts, and the addresses
+// held in registers (e.g. DMA read and write addresses) the same as on the chip.
+
+extern "C" {
+
+// Stand-ins for symbols from `layout.ld`; only `__reset` and `initTLS` refer to these,
+// and they never run on the host.
+[[gnu::weak]] void* __sram_begin;
+[[gnu::weak]] void* __sram_end;
+[[gnu::weak]] void* __time_critical_flash_begin;
+[[gnu::weak]] void* __time_critical_sram_begin;
+[[gnu::weak]] void* __time_critical_sram_end;
+[[gnu::weak]] void* __data_flash_begin;
+[[gnu::weak]] void* __data_sram_begin;
+[[gnu::weak]] void* __data_sram_end;
+[[gnu::weak]] void* __init_array_begin;
+[[gnu::weak]] void* __init_array_end;
+[[gnu::weak]] void* __bss_begin;
+[[gnu::weak]] void* __bss_end;
+[[gnu::weak]] void* __tdata_begin;
+[[gnu::weak]] void* __tdata_end;
+[[gnu::weak]] void* __tbss_end;
+[[gnu::weak]] void* __tls_offset;
+[[gnu::weak]] void* __tls_block;
+[[gnu::weak]] void* __tls_core0;
+[[gnu::weak]] void* __tls_core1;
+[[gnu::weak]] void* __heap;
+[[gnu::weak]] void* __heap_end;
+[[gnu::weak]] void __start() {}
+
+} // extern "C"
+
+namespace rp2350::sim {
+
+struct Model;
+
+struct Sim {
+    constexpr static uintptr_t kPage = 0x1000;
+    constexpr static unsigned kMaxDispatch = 64; // IRQs taken per `idle`
+
+    struct Region {
+        uintptr_t base;
+        uintptr_t size;
+        bool aliases;    // has atomic XOR / SET / CLR aliases at +0x1000 / 2000 / 3000
+        uint8_t* shadow; // current register values
+    };
+
+    // An access in flight: the page it touches is open for one instruction
+    struct Pending {
+        uintptr_t page;
+        uintptr_t addr;
+        bool write;
+        uint32_t before[kPage / 4]; // page contents as given to the instruction
+    };
+
+    Region regions_[4] {
+        {0x40000000, 0x00200000, true, nullptr},  // APB peripherals
+        {0x50000000, 0x00700000, true, nullptr},  // AHB peripherals: DMA, HSTX FIFO
+        {0xd0000000, 0x00020000, false, nullptr}, // SIO
+        {0xe0000000, 0x00100000, false, nullptr}, // Cortex-M33 private peripheral bus
+    };
+
+    Model* models_ {};
+    bool started_ {};
+    Pending pending_[2];
+    unsigned nPending_ {};
+    uint64_t irqEnabled_ {}; // NVIC state; see `NVICModel`
+    uint64_t irqPending_ {};
+    uint32_t otherReads_ {}; // accesses to addresses with no model
+    uint32_t otherWrites_ {};
+
+    void start();
+    void idle();
+    void dump();
+    void resetCounts();
+
+    Region* regionOf(uintptr_t a) {
+        for (auto& r : regions_) {
+            if (a - r.base < r.size) { return &r; }
+        }
+        return nullptr;
+    }
+
+    // The register an address refers to, seeing through the atomic aliases
+    static uintptr_t canonical(Region const& r, uintptr_t a) {
+        return r.aliases ? (a & ~uintptr_t(0x3000)) : a;
+    }
+
+    uint32_t& shadow(uintptr_t reg) {
+        auto* r = regionOf(reg);
+        return *(uint32_t*)(r->shadow + (reg - r->base));
+    }
+
+    Model* modelOf(uintptr_t reg);
+
+    // Register accesses as seen by peripherals, counted; `write` takes the address
+    // actually written, which may be an alias.
+    uint32_t read(uintptr_t reg);
+    void write(uintptr_t addr, uint32_t raw);
+
+    // Accesses by a bus master other than the CPU (e.g. DMA): simulated registers go
+    // through their models, anything else is plain host memory.
+    uint32_t busRead(uintptr_t addr, unsigned size) {
+        if (auto* r = regionOf(addr)) {
+            auto shift = (addr & 3) * 8;
+            auto mask = size == 4 ? ~uint32_t(0) : ((uint32_t(1) << (size * 8)) - 1);
+            return (read(canonical(*r, addr & ~uintptr_t(3))) >> shift) & mask;
+        }
+        switch (size) {
+        case 1: return *(uint8_t*)addr;
+        case 2: return *(uint16_t*)addr;
+        default: return *(uint32_t*)addr;
+        }
+    }
+
+    void busWrite(uintptr_t addr, uint32_t value, unsigned size) {
+        if (auto* r = regionOf(addr)) {
+            auto word = addr & ~uintptr_t(3);
+            if (size < 4) {
+                auto shift = (addr & 3) * 8;
+                auto mask = ((uint32_t(1) << (size * 8)) - 1) << shift;
+                auto old = shadow(canonical(*r, word));
+                value = (old & ~mask) | ((value << shift) & mask);
+            }
+            write(word, value);
+            return;
+        }
+        switch (size) {
+        case 1: *(uint8_t*)addr = uint8_t(value); break;
+        case 2: *(uint16_t*)addr = uint16_t(value); break;
+        default: *(uint32_t*)addr = value; break;
+        }
+    }
+
+    void raiseIRQ(unsigned irq) { irqPending_ |= uint64_t(1) << irq; }
+
+    // Called from the SIGSEGV handler: open up the page at `a` for one instruction
+    void begin(Region& r, uintptr_t a, bool isWrite) {
+        auto word = a & ~uintptr_t(3);
+        auto& p = pending_[nPending_++];
+        p.page = word & ~(kPage - 1);
+        p.addr = word;
+        p.write = isWrite;
+        memcpy(p.before, &shadow(canonical(r, p.page)), kPage);
+        if (!isWrite) { p.before[(word - p.page) / 4] = read(canonical(r, word)); }
+        mprotect((void*)p.page, kPage, PROT_READ | PROT_WRITE);
+        memcpy((void*)p.page, p.before, kPage);
+    }
+
+    // Called from the SIGTRAP handler, after the instruction: pass on what was written
+    void finish() {
+        for (unsigned i = 0; i < nPending_; i++) {
+            auto& p = pending_[i];
+            auto* now = (uint32_t*)p.page;
+            for (unsigned w = 0; w < kPage / 4; w++) {
+                auto addr = p.page + w * 4;
+                if (now[w] != p.before[w] || (p.write && addr == p.addr)) {
+                    write(addr, now[w]);
+                }
+            }
+            mprotect((void*)p.page, kPage, PROT_NONE);
+        }
+        nPending_ = 0;
+    }
+};
+
+inline Sim sim;
+
+// A simulated peripheral, owning `size` bytes of registers at `base`.  Models register
+// themselves on construction; later ones take precedence, so a test can override a
+// default model with its own.
+struct Model {
+    char const* name_;
+    uintptr_t base_;
+    uint32_t size_;
+    Model* next_;
+    uint32_t reads_ {};
+    uint32_t writes_ {};
+
+    Model(char const* name, uintptr_t base, uint32_t size)
+            : name_(name), base_(base), size_(size), next_(sim.models_) {
+        sim.models_ = this;
+    }
+
+    virtual ~Model() = default;
+
+    uint32_t& reg(uint32_t offset) { return sim.shadow(base_ + offset); }
+
+    // Value of the register at `offset`, as the CPU (or DMA) reads it
+    virtual uint32_t read(uint32_t offset) { return reg(offset); }
+
+    // New value for the register at `offset` (alias operations already applied)
+    virtual void write(uint32_t offset, uint32_t value) { reg(offset) = value; }
+
+    // Background work: called on each `sim.idle()`
+    virtual void tick() {}
+};
+
+inline Model* Sim::modelOf(uintptr_t reg) {
+    for (auto* m = models_; m; m = m->next_) {
+        if (reg - m->base_ < m->size_) { return m; }
+    }
+    return nullptr;
+}
+
+inline uint32_t Sim::read(uintptr_t reg) {
+    if (auto* m = modelOf(reg)) {
+        ++m->reads_;
+        return m->read(uint32_t(reg - m->base_));
+    }
+    ++otherReads_;
+    return shadow(reg);
+}
+
+inline void Sim::write(uintptr_t addr, uint32_t raw) {
+    auto& r = *regionOf(addr);
+    auto reg = canonical(r, addr);
+    auto old = shadow(reg);
+    uint32_t value;
+    switch (r.aliases ? (addr >> 12) & 3 : 0) {
+    case 1: value = old ^ raw; break;
+    case 2: value = old | raw; break;
+    case 3: value = old & ~raw; break;
+    default: value = raw; break;
+    }
+    if (auto* m = modelOf(reg)) {
+        ++m->writes_;
+        m->write(uint32_t(reg - m->base_), value);
+    } else {
+        ++otherWrites_;
+        shadow(reg) = value;
+    }
+}
+
+// 7.5. Resets: blocks come out of (or go into) reset immediately
+struct ResetsModel : Model {
+    constexpr static uint32_t kAll = 0x1fffffff;
+    ResetsModel() : Model("RESETS", 0x40020000, 0x0c) {}
+
+    uint32_t read(uint32_t offset) override {
+        if (offset == 0x08) { return ~reg(0x00) & kAll; } // RESET_DONE
+        return reg(offset);
+    }
+};
+
+// 8.2. XOSC: stable as soon as it's enabled; `count` always reads as expired
+struct XOSCModel : Model {
+    XOSCModel() : Model("XOSC", 0x40048000, 0x14) {}
+
+    uint32_t read(uint32_t offset) override {
+        if (offset == 0x04) { // STATUS
+            bool on = ((reg(0x00) >> 12) & 0xfff) == 0xfab;
+            return (reg(0x00) & 3) | (on ? (1u << 12) | (1u << 31) : 0);
+        }
+        if (offset == 0x10) { return 0; } // COUNT
+        return reg(offset);
+    }
+};
+
+// 8.6. PLL: locks as soon as it's powered up with a feedback divisor
+struct PLLModel : Model {
+    PLLModel(char const* name, uintptr_t base) : Model(name, base, 0x20) {}
+
+    uint32_t read(uint32_t offset) override {
+        if (offset == 0x00) { // CS
+            bool locked = reg(0x08) && !(reg(0x04) & ((1u << 0) | (1u << 5)));
+            return (reg(0x00) & ~(1u << 31)) | (locked ? (1u << 31) : 0);
+        }
+        return reg(offset);
+    }
+};
+
+// 12.1. UART: transmits instantly into `tx_`; `push` feeds received characters
+template <unsigned kIRQ> struct UARTModel : Model {
+    constexpr static unsigned kBuf = 4096;
+
+    char tx_[kBuf] {};
+    uint32_t txCount_ {};
+    char rx_[kBuf] {};
+    uint32_t rxHead_ {};
+    uint32_t rxTail_ {};
+
+    UARTModel(char const* name, uintptr_t base) : Model(name, base, 0x48) {}
+
+    void push(char c) {
+        rx_[rxTail_++ % kBuf] = c;
+        if (reg(0x38) & (1u << 4)) { sim.raiseIRQ(kIRQ); } // IMSC.RXIM
+    }
+
+    uint32_t read(uint32_t offset) override {
+        switch (offset) {
+        case 0x00: return rxHead_ != rxTail_ ? uint8_t(rx_[rxHead_++ % kBuf]) : 0;
+        case 0x18: return (rxHead_ == rxTail_ ? (1u << 4) : 0) | (1u << 7); // FR
+        default: return reg(offset);
+        }
+    }
+
+    void write(uint32_t offset, uint32_t value) override {
+        if (offset == 0x00) {
+            tx_[txCount_++ % kBuf] = char(value);
+            return;
+        }
+        reg(offset) = value;
+    }
+};
+
+// 12.11.8. HSTX FIFO: never full; keeps the most recent `kWords` words written
+struct HSTXFIFOModel : Model {
+    constexpr static unsigned kWords = 4096;
+
+    uint32_t words_[kWords] {};
+    uint32_t count_ {};
+
+    HSTXFIFOModel() : Model("HSTX_FIFO", 0x50600000, 0x08) {}
+
+    uint32_t read(uint32_t offset) override {
+        if (offset == 0x00) { return 1u << 9; } // STAT: empty
+        return reg(offset);
+    }
+
+    void write(uint32_t offset, uint32_t value) override {
+        if (offset == 0x04) {
+            words_[count_++ % kWords] = value;
+            return;
+        }
+        reg(offset) = value;
+    }
+};
+
+// 12.6. DMA: transfers run to completion when triggered (ignoring DREQ pacing).  A
+// channel chained to from another one starts on the next `sim.idle()`, so that a
+// ping-ponging pair of channels doesn't run forever within one access.
+struct DMAModel : Model {
+    struct Channel {
+        uint32_t read;
+        uint32_t write;
+        uint32_t count;  // remaining
+        uint32_t reload; // last TRANS_COUNT written
+        uint32_t ctrl;
+    };
+
+    // 12.6.10: each channel's 16 words are four aliased orderings of its four
+    // registers (read, write, count, ctrl); the last in each is a trigger
+    constexpr static uint8_t kRead = 0, kWrite = 1, kCount = 2, kCtrl = 3, kTrig = 4;
+    // clang-format off
+    constexpr static uint8_t kLayout[16] {
+        kRead, kWrite, kCount, kCtrl | kTrig,
+        kCtrl, kRead,  kWrite, kCount | kTrig,
+        kCtrl, kCount, kRead,  kWrite | kTrig,
+        kCtrl, kWrite, kCount, kRead | kTrig,
+    };
+    // clang-format on
+    constexpr static unsigned kIRQBase = 10; // p.84: DMA_IRQ_0 .. 3
+
+    Channel channels_[16] {};
+    uint32_t intr_ {};
+    uint32_t inte_[4] {};
+    uint32_t intf_[4] {};
+    uint32_t queued_ {};
+
+    DMAModel() : Model("DMA", 0x50000000, 0x460) {}
+
+    uint32_t& field(Channel& c, unsigned which) {
+        switch (which) {
+        case kRead: return c.read;
+        case kWrite: return c.write;
+        case kCount: return c.count;
+        default: return c.ctrl;
+        }
+    }
+
+    uint32_t read(uint32_t offset) override {
+        if (offset < 0x400) {
+            auto& c = channels_[offset >> 6];
+            return field(c, kLayout[(offset >> 2) & 15] & 3); // (never busy)
+        }
+        if (offset == 0x400) { return intr_; }
+        if (offset >= 0x404 && offset < 0x440 && (offset & 0x0f)) {
+            auto k = (offset - 0x404) >> 4;
+            switch (offset & 0x0f) {
+            case 0x04: return inte_[k];
+            case 0x08: return intf_[k];
+            default: return (intr_ | intf_[k]) & inte_[k];
+            }
+        }
+        return reg(offset);
+    }
+
+    void write(uint32_t offset, uint32_t value) override {
+        if (offset < 0x400) {
+            auto ch = offset >> 6;
+            auto& c = channels_[ch];
+            auto which = kLayout[(offset >> 2) & 15];
+            field(c, which & 3) = value;
+            if ((which & 3) == kCount) { c.reload = value; }
+            // (A zero written to a trigger register is a "null trigger")
+            if ((which & kTrig) && value && (c.ctrl & 1)) { run(ch); }
+            return;
+        }
+        if (offset == 0x400) {
+            intr_ &= ~value;
+        } else if (offset >= 0x404 && offset < 0x440 && (offset & 0x0f)) {
+            auto k = (offset - 0x404) >> 4;
+            switch (offset & 0x0f) {
+            case 0x04: inte_[k] = value; break;
+            case 0x08: intf_[k] = value; break;
+            default: intr_ &= ~value; break;
+            }
+        } else if (offset == 0x450) {
+            for (unsigned ch = 0; ch < 16; ch++) {
+                if ((value >> ch) & 1) { run(ch); }
+            }
+        } else {
+            reg(offset) = value;
+        }
+        updateIRQs();
+    }
+
+    void run(unsigned ch) {
+        auto& c = channels_[ch];
+        auto size = 1u << ((c.ctrl >> 2) & 3);
+        c.count = c.reload;
+        for (auto n = c.count & 0x0fffffff; n; --n) {
+            sim.busWrite(c.write, sim.busRead(c.read, size), size);
+            if (c.ctrl & (1u << 4)) { c.read += size; }  // INCR_READ
+            if (c.ctrl & (1u << 6)) { c.write += size; } // INCR_WRITE
+        }
+        c.count &= 0xf0000000;
+        if (!(c.ctrl & (1u << 23))) { intr_ |= 1u << ch; } // IRQ_QUIET
+        auto chainTo = (c.ctrl >> 13) & 15;
+        if (chainTo != ch) { queued_ |= 1u << chainTo; }
+        updateIRQs();
+    }
+
+    void updateIRQs() {
+        for (unsigned k = 0; k < 4; k++) {
+            if ((intr_ | intf_[k]) & inte_[k]) { sim.raiseIRQ(kIRQBase + k); }
+        }
+    }
+
+    void tick() override {
+        auto queued = queued_;
+        queued_ = 0;
+        for (unsigned ch = 0; ch < 16; ch++) {
+            if (((queued >> ch) & 1) && (channels_[ch].ctrl & 1)) { run(ch); }
+        }
+    }
+};
+
+// 12.8. Timer: virtual microseconds.  Every read of TIMERAWL moves time on by 1us, so
+// that polling loops finish; `sim.idle()` (e.g. from a WFE) skips ahead to the nearest
+// armed alarm, or else by 1us.  Alarms fire when the low word reaches them.
+struct TimerModel : Model {
+    unsigned irqBase_;
+    uint64_t us_ {};
+    uint32_t alarms_[4] {};
+    uint32_t armed_ {};
+    uint32_t intr_ {};
+
+    TimerModel(char const* name, uintptr_t base, unsigned irqBase)
+            : Model(name, base, 0x4c), irqBase_(irqBase) {}
+
+    void advance(uint64_t us) {
+        auto from = uint32_t(us_);
+        us_ += us;
+        for (unsigned n = 0; n < 4; n++) {
+            // Did the low word pass (or land on) this alarm?
+            if (((armed_ >> n) & 1) && alarms_[n] - from - 1 < us) {
+                armed_ &= ~(1u << n);
+                intr_ |= 1u << n;
+            }
+        }
+        updateIRQs();
+    }
+
+    void updateIRQs() {
+        auto active = (intr_ | reg(0x44)) & reg(0x40); // (INTR | INTF) & INTE
+        for (unsigned n = 0; n < 4; n++) {
+            if ((active >> n) & 1) { sim.raiseIRQ(irqBase_ + n); }
+        }
+    }
+
+    uint32_t read(uint32_t offset) override {
+        switch (offset) {
+        case 0x08:
+        case 0x24: return uint32_t(us_ >> 32); // TIMEHR, TIMERAWH
+        case 0x0c: return uint32_t(us_);       // TIMELR
+        case 0x28: {                           // TIMERAWL
+            auto lo = uint32_t(us_);
+            advance(1);
+            return lo;
+        }
+        case 0x10:
+        case 0x14:
+        case 0x18:
+        case 0x1c: return alarms_[(offset - 0x10) >> 2];
+        case 0x20: return armed_;
+        case 0x3c: return intr_;
+        case 0x48: return (intr_ | reg(0x44)) & reg(0x40); // INTS
+        default: return reg(offset);
+        }
+    }
+
+    void write(uint32_t offset, uint32_t value) override {
+        switch (offset) {
+        case 0x00: us_ = (uint64_t(value) << 32) | reg(0x04); break; // TIMEHW
+        case 0x10:
+        case 0x14:
+        case 0x18:
+        case 0x1c: {
+            auto n = (offset - 0x10) >> 2;
+            alarms_[n] = value;
+            armed_ |= 1u << n;
+            break;
+        }
+        case 0x20: armed_ &= ~value; break;
+        case 0x3c: intr_ &= ~value; break;
+        default: reg(offset) = value; break;
+        }
+        updateIRQs();
+    }
+
+    void tick() override {
+        uint64_t step = 0;
+        for (unsigned n = 0; n < 4; n++) {
+            if ((armed_ >> n) & 1) {
+                auto until = uint64_t(alarms_[n] - uint32_t(us_));
+                if (until && (!step || until < step)) { step = until; }
+            }
+        }
+        advance(step ? step : 1);
+    }
+};
+
+// NVIC enable / pending registers (ISER, ICER, ISPR, ICPR), for `sim.idle()` to know
+// which IRQs to take
+struct NVICModel : Model {
+    NVICModel() : Model("NVIC", 0xe000e100, 0x200) {}
+
+    static uint32_t half(uint64_t bits, uint32_t offset) {
+        return uint32_t(bits >> (((offset >> 2) & 1) * 32));
+    }
+
+    static uint64_t widen(uint32_t value, uint32_t offset) {
+        return uint64_t(value) << (((offset >> 2) & 1) * 32);
+    }
+
+    uint32_t read(uint32_t offset) override {
+        return half(offset < 0x100 ? sim.irqEnabled_ : sim.irqPending_, offset);
+    }
+
+    void write(uint32_t offset, uint32_t value) override {
+        auto bits = widen(value, offset);
+        switch (offset >> 7) {
+        case 0: sim.irqEnabled_ |= bits; break;
+        case 1: sim.irqEnabled_ &= ~bits; break;
+        case 2: sim.irqPending_ |= bits; break;
+        default: sim.irqPending_ &= ~bits; break;
+        }
+    }
+};
+
+inline ResetsModel resetsModel;
+inline XOSCModel xoscModel;
+inline PLLModel sysPLLModel {"PLL_SYS", 0x40050000};
+inline PLLModel usbPLLModel {"PLL_USB", 0x40058000};
+inline UARTModel<33> uart0Model {"UART0", 0x40070000};
+inline UARTModel<34> uart1Model {"UART1", 0x40078000};
+inline HSTXFIFOModel hstxFIFOModel;
+inline DMAModel dmaModel;
+inline TimerModel timer0Model {"TIMER0", 0x400b0000, 0};
+inline TimerModel timer1Model {"TIMER1", 0x400b8000, 4};
+inline NVICModel nvicModel;
+
+inline void onFault(int, siginfo_t* info, void* context) {
+    auto* uc = (ucontext_t*)context;
+    auto a = uintptr_t(info->si_addr);
+    auto* r = sim.regionOf(a);
+    if (!r || sim.nPending_ == 2) {
+        signal(SIGSEGV, SIG_DFL); // not ours: fault again, for real
+        return;
+    }
+    sim.begin(*r, a, uc->uc_mcontext.gregs[REG_ERR] & 2);
+    uc->uc_mcontext.gregs[REG_EFL] |= 0x100; // TF: trap after one instruction
+}
+
+inline void onTrap(int, siginfo_t*, void* context) {
+    auto* uc = (ucontext_t*)context;
+    if (!sim.nPending_) {
+        signal(SIGTRAP, SIG_DFL);
+        raise(SIGTRAP);
+        return;
+    }
+    sim.finish();
+    uc->uc_mcontext.gregs[REG_EFL] &= ~0x100;
+}
+
+inline void Sim::start() {
+    if (started_) { return; }
+    started_ = true;
+    for (auto& r : regions_) {
+        auto* p = mmap((void*)r.base, r.size, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        if (p != (void*)r.base) { __abort(); }
+        r.shadow = (uint8_t*)mmap(nullptr, r.size, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (r.shadow == MAP_FAILED) { __abort(); }
+    }
+
+    struct sigaction sa {};
+    sa.sa_flags = SA_SIGINFO;
+    sa.sa_sigaction = onFault;
+    sigaction(SIGSEGV, &sa, nullptr);
+    sa.sa_sigaction = onTrap;
+    sigaction(SIGTRAP, &sa, nullptr);
+
+    __hostIdle = [] { sim.idle(); };
+}
+
+// Let models make progress, then take pending, enabled IRQs (if interrupts are
+// enabled) through the vector table, as the NVIC would.  If one's pending already,
+// take it first, as a WFI would return at once: otherwise time could skip ahead to
+// an alarm which that IRQ was to move (e.g. `TimerWheel::rearm`).
+inline void Sim::idle() {
+    if (!__hostIRQsEnabled || !(irqPending_ & irqEnabled_)) {
+        for (auto* m = models_; m; m = m->next_) { m->tick(); }
+    }
+    for (unsigned i = 0; i < kMaxDispatch && __hostIRQsEnabled; i++) {
+        auto ready = irqPending_ & irqEnabled_;
+        if (!ready) { break; }
+        auto irq = unsigned(__builtin_ctzll(ready));
+        irqPending_ &= ~(uint64_t(1) << irq);
+        if (irq >= kIRQHandlers) { continue; }
+        __hostIPSR = 16 + irq;
+        coreVectors[0]->irqs[irq](); // (core 0's: only one's simulated)
+        __hostIPSR = 0;
+    }
+}
+
+inline void Sim::dump() {
+    printf("%-12s %10s %10s\n", "model", "reads", "writes");
+    for (auto* m = models_; m; m = m->next_) {
+        if (m->reads_ || m->writes_) {
+            printf("%-12s %10u %10u\n", m->name_, unsigned(m->reads_),
+                   unsigned(m->writes_));
+        }
+    }
+    printf("%-12s %10u %10u\n", "(unmodelled)", unsigned(otherReads_),
+           unsigned(otherWrites_));
+}
+
+inline void Sim::resetCounts() {
+    for (auto* m = models_; m; m = m->next_) { m->reads_ = m->writes_ = 0; }
+    otherReads_ = otherWrites_ = 0;
+}
+
+} // namespace rp2350::sim
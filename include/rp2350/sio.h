@@ -0,0 +1,69 @@
+#pragma once
+
+#include <platform.h>
+#include <rp2350/common.h>
+
+namespace rp2350 {
+
+// Section 3.1, SIO; GPIO registers in section 9.8, Processor GPIO Controls
+// https://datasheets.raspberrypi.com/rp2350/rp2350-datasheet.pdf
+//
+// Note that for simplicity this only supports Bank0.
+// We'll assume Bank1 is not dealt with; the pins in Bank1
+// will then continue to be reserved only for QSPI.
+//
+// Each core sees its own SIO at the same address: `cpuID` reads 0 or 1 depending on
+// which core asks, and the inter-core FIFO registers are this core's ends of the two
+// FIFOs (3.1.5), writing to the other core and reading from it.
+struct SIO : R32 {
+    // 3.1.5: FIFO_ST
+    constexpr static unsigned kFIFOValid = 1u << 0; // VLD: RX FIFO not empty
+    constexpr static unsigned kFIFOReady = 1u << 1; // RDY: TX FIFO not full
+    constexpr static unsigned kFIFOWOF = 1u << 2;   // sticky: wrote to a full TX FIFO
+    constexpr static unsigned kFIFOROE = 1u << 3;   // sticky: read an empty RX FIFO
+
+    unsigned cpuID;         // 0xd0000000
+    unsigned gpioIn;        // 0xd0000004
+    unsigned z_008;         // 0xd0000008
+    unsigned z_00c;         // 0xd000000c
+    unsigned gpioOut;       // 0xd0000010
+    unsigned z_014;         // 0xd0000014
+    unsigned gpioOutSet;    // 0xd0000018
+    unsigned z_01c;         // 0xd000001c
+    unsigned gpioOutClr;    // 0xd0000020
+    unsigned z_0;           // 0xd0000024
+    unsigned gpioOutXor;    // 0xd0000028
+    unsigned z_02c;         // 0xd000002c
+    unsigned gpioOutEnb;    // 0xd0000030
+    unsigned z_034;         // 0xd0000034
+    unsigned gpioOutEnbSet; // 0xd0000038
+    unsigned z_03c;         // 0xd000003c
+    unsigned gpioOutEnbClr; // 0xd0000040
+    unsigned z_044;         // 0xd0000044
+    unsigned gpioOutEnbXor; // 0xd0000048
+    unsigned z_04c;         // 0xd000004c
+    unsigned fifoStatus;    // 0xd0000050: FIFO_ST; write to clear WOF / ROE
+    unsigned fifoWrite;     // 0xd0000054: FIFO_WR
+    unsigned fifoRead;      // 0xd0000058: FIFO_RD
+    unsigned spinlockState; // 0xd000005c: bit N set while spinlock N is held
+    unsigned z_060[8];      // 0xd0000060
+    unsigned interp0[16];   // 0xd0000080; TODO
+    unsigned interp1[16];   // 0xd00000c0; TODO
+    unsigned spinlock[32];  // 0xd0000100: read claims (0: already held); write frees
+
+    // 3.1.6: setting a bit in `doorbellOutSet` sets it in the other core's
+    // `doorbellInSet`, raising SIO_IRQ_BELL there until it's written to `doorbellInClr`
+    unsigned doorbellOutSet; // 0xd0000180
+    unsigned doorbellOutClr; // 0xd0000184
+    unsigned doorbellInSet;  // 0xd0000188
+    unsigned doorbellInClr;  // 0xd000018c
+
+    // TODO:
+    // lots more
+};
+inline auto& sio = *(SIO volatile*)(0xd0000000);
+
+// Which core this is running on: 0 or 1
+inline unsigned coreNum() { return sio.cpuID; }
+
+} // namespace rp2350
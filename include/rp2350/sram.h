@@ -0,0 +1,89 @@
+#pragma once
+
+#include <platform.h>
+#include <rp2350/buscontrol.h>
+
+extern "C" {
+
+// Defined in the linker script: the first free byte after each bank-pinned section,
+// and the end of its region
+extern uint8_t __sram_hi_free[];
+extern uint8_t __sram_hi_end[];
+extern uint8_t __scratch_x_free[];
+extern uint8_t __scratch_x_end[];
+extern uint8_t __scratch_y_free[];
+extern uint8_t __scratch_y_end[];
+
+} // extern "C"
+
+namespace rp2350 {
+
+// 4.2. SRAM
+//
+// Main SRAM is two 256k regions, each word-striped across four banks (SRAM0-3 and
+// SRAM4-7), followed by two unstriped 4k banks, SRAM8 and SRAM9 (the "scratch" banks).
+// The crossbar can serve each bank once per cycle, so placing e.g. DMA buffers, the
+// stacks, and CPU-heavy data in separate groups keeps these masters from stalling each
+// other.  See `layout.ld` for which region holds what.
+//
+// Statically-allocated objects can be pinned with a section attribute:
+//
+//     [[gnu::section(".scratch_x")]] uint32_t stack[256];
+//
+// These sections are NOLOAD: contents are neither loaded from flash nor zeroed at
+// reset, so give such objects no initializer.  For sizes known only at runtime, use
+// `bankAlloc`, which hands out the remainder of each region after its section.
+
+enum class Bank : unsigned {
+    SRAM_HI = 0,   // SRAM4-7, striped; e.g. DMA / HSTX buffers
+    SCRATCH_X = 1, // SRAM8; e.g. core 0 stack, per-line buffers
+    SCRATCH_Y = 2, // SRAM9; e.g. core 1 stack, per-line buffers
+};
+
+// Bump allocator over one bank region.  Nothing is ever freed; this is meant for
+// buffers set up once at init time (and is not interrupt-safe).
+struct BankArena {
+    uint8_t* next_;
+    uint8_t* end_;
+
+    void* alloc(size_t size, size_t align) {
+        auto p = (uintptr_t(next_) + align - 1) & ~(align - 1);
+        if (p < uintptr_t(next_) || size > uintptr_t(end_) - p) { return nullptr; }
+        next_ = (uint8_t*)(p + size);
+        return (void*)p;
+    }
+
+    size_t remaining() const { return size_t(end_ - next_); }
+};
+
+inline BankArena bankArenas[] {
+    {__sram_hi_free, __sram_hi_end},
+    {__scratch_x_free, __scratch_x_end},
+    {__scratch_y_free, __scratch_y_end},
+};
+
+// Get `size` bytes (uninitialized) in bank region `bank`, or nullptr if it's full.
+// `align` must be a power of two.
+inline void* bankAlloc(Bank bank, size_t size, size_t align = 4) {
+    return bankArenas[unsigned(bank)].alloc(size, align);
+}
+
+inline size_t bankRemaining(Bank bank) {
+    return bankArenas[unsigned(bank)].remaining();
+}
+
+// The physical bank (0-9) holding the word at `p`, for SRAM addresses.
+inline unsigned sramBankOf(void const* p) {
+    auto offset = uintptr_t(p) - 0x20000000;
+    if (offset >= 0x80000) { return 8 + ((offset - 0x80000) >> 12); }
+    return ((offset >> 18) << 2) + ((offset >> 2) & 3);
+}
+
+// The bus performance counter port for SRAM bank `i` (see `BusControl::perfSelect`);
+// e.g. count `ACCESS_CONTESTED` events on the bank a buffer lives in, to compare
+// striped and bank-pinned placement.
+inline BusControl::Port sramPort(unsigned i) {
+    return BusControl::Port(unsigned(BusControl::Port::SRAM0) - i);
+}
+
+} // namespace rp2350
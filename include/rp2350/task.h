@@ -0,0 +1,246 @@
+#pragma once
+
+#include <coro.h>
+#include <platform.h>
+#include <pool.h>
+#include <rp2350/insns.h>
+#include <rp2350/timerwheel.h>
+
+#if !defined(RP2350_TASK_FRAMES)
+#define RP2350_TASK_FRAMES 16
+#endif
+
+#if !defined(RP2350_TASK_FRAME_BYTES)
+#define RP2350_TASK_FRAME_BYTES 256
+#endif
+
+namespace rp2350 {
+
+// Coroutine tasks on a single-core, interrupt-driven executor.
+//
+// A `Task` is a coroutine which runs until it awaits something not yet available (an
+// `Event`, a `Sleep`, or the awaitables in `taskio.h`), and is resumed from the
+// executor's loop once an ISR signals it.  So driver logic can be written as straight
+// line code, while the CPU sleeps (WFI) whenever nothing is ready:
+//
+//     Task blink() {
+//         while (true) {
+//             sio.gpioOutXor = 1 << 25;
+//             co_await sleepFor(gWheel, 500'000);
+//         }
+//     }
+//
+//     executor.spawn(blink());
+//     executor.run();
+//
+// Frames come from a pool of `RP2350_TASK_FRAMES` blocks of `RP2350_TASK_FRAME_BYTES`
+// each, never the heap.  A coroutine whose frame doesn't fit, or which finds the pool
+// exhausted, is an empty `Task`, which `spawn` refuses.  Tasks run to completion
+// detached: a finished task's frame goes straight back to the pool.
+
+struct TaskFrame {
+    alignas(8) uint8_t bytes[RP2350_TASK_FRAME_BYTES];
+};
+
+inline Pool<TaskFrame, RP2350_TASK_FRAMES> taskFrames;
+
+// A task's place in the executor's ready list; one per task, in its promise
+struct Waker {
+    Waker* next_ {};
+    void* frame_ {};
+};
+
+struct Task {
+    struct promise_type {
+        Waker waker_;
+
+        static void* operator new(size_t n) noexcept {
+            return n <= sizeof(TaskFrame) ? taskFrames.alloc() : nullptr;
+        }
+
+        static void operator delete(void* p) { taskFrames.free(p); }
+
+        static Task get_return_object_on_allocation_failure() { return {}; }
+
+        Task get_return_object() {
+            waker_.frame_ = std::coroutine_handle<promise_type>::from_promise(*this)
+                                .address();
+            return Task {waker_.frame_};
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { __abort(); }
+    };
+
+    void* frame_ {};
+
+    Task() = default;
+    explicit Task(void* frame) : frame_(frame) {}
+    Task(Task&& other) : frame_(other.frame_) { other.frame_ = nullptr; }
+    Task(Task const&) = delete;
+    Task& operator=(Task const&) = delete;
+
+    // Never spawned: never started, so just free it
+    ~Task() {
+        if (frame_) { std::coroutine_handle<>::from_address(frame_).destroy(); }
+    }
+
+    explicit operator bool() const { return frame_; }
+
+    Waker& waker() const {
+        auto h = std::coroutine_handle<promise_type>::from_address(frame_);
+        return h.promise().waker_;
+    }
+};
+
+struct Executor {
+    Waker* ready_ {};     // pushed from anywhere (LDREX/STREX), newest first
+    uint32_t spawned_ {}; // tasks started
+    uint32_t refused_ {}; // empty tasks passed to `spawn` (frame allocation failed)
+    uint32_t resumes_ {}; // times a task was resumed
+    uint32_t idles_ {};   // times the loop found nothing ready, and slept
+
+    // Queue `w`'s task to be resumed; from thread code or any ISR
+    void wake(Waker& w) {
+        auto* head = __atomic_load_n(&ready_, __ATOMIC_RELAXED);
+        do {
+            w.next_ = head;
+        } while (!__atomic_compare_exchange_n(&ready_, &head, &w, true,
+                                              __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+
+    // Start `task` running (from the loop); false if it's empty
+    bool spawn(Task&& task) {
+        if (!task) {
+            ++refused_;
+            return false;
+        }
+        ++spawned_;
+        auto& w = task.waker();
+        task.frame_ = nullptr;
+        wake(w);
+        return true;
+    }
+
+    // Resume every task woken so far, oldest first; false if there were none
+    bool runReady() {
+        auto* list = __atomic_exchange_n(&ready_, nullptr, __ATOMIC_ACQUIRE);
+        if (!list) { return false; }
+        Waker* fifo = nullptr;
+        while (list) {
+            auto* next = list->next_;
+            list->next_ = fifo;
+            fifo = list;
+            list = next;
+        }
+        while (fifo) {
+            auto* w = fifo;
+            fifo = w->next_;
+            w->next_ = nullptr;
+            ++resumes_;
+            std::coroutine_handle<>::from_address(w->frame_).resume();
+        }
+        return true;
+    }
+
+    // Sleep until an interrupt, unless something's already been woken.  IRQs are
+    // masked around the check, so one arriving just before the WFI still ends it (and
+    // is taken once they're unmasked).  On the host, IRQs are only ever taken within
+    // `__wfi`, so there's no such race to close.
+    void idle() {
+        ++idles_;
+#if defined(RP2350_HOST)
+        if (!__atomic_load_n(&ready_, __ATOMIC_RELAXED)) { __wfi(); }
+#else
+        __disableIRQs();
+        if (!__atomic_load_n(&ready_, __ATOMIC_RELAXED)) { __wfi(); }
+        __enableIRQs();
+#endif
+    }
+
+    [[noreturn]] void run() {
+        while (true) {
+            if (!runReady()) { idle(); }
+        }
+    }
+};
+
+inline Executor executor;
+
+// A one-shot signal from an ISR (or anywhere) to at most one waiting task.  A signal
+// with no task waiting is kept until the next `co_await`, which then doesn't suspend;
+// repeated signals before that count as one.
+struct Event {
+    constexpr static uintptr_t kSignaled = 1;
+
+    uintptr_t state_ {}; // 0, `kSignaled`, or the waiting task's `Waker*`
+
+    void signal() {
+        auto state = __atomic_load_n(&state_, __ATOMIC_ACQUIRE);
+        while (state != kSignaled) {
+            auto next = state ? 0 : kSignaled;
+            if (__atomic_compare_exchange_n(&state_, &state, next, true,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                if (state) { executor.wake(*(Waker*)state); }
+                return;
+            }
+        }
+    }
+
+    // Forget a signal which nobody waited for
+    void reset() {
+        auto state = kSignaled;
+        __atomic_compare_exchange_n(&state_, &state, 0, false, __ATOMIC_RELAXED,
+                                    __ATOMIC_RELAXED);
+    }
+
+    bool await_ready() {
+        auto state = kSignaled;
+        return __atomic_compare_exchange_n(&state_, &state, 0, false,
+                                           __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    }
+
+    // Register as the waiter; false (don't suspend) if signaled since `await_ready`
+    bool await_suspend(std::coroutine_handle<Task::promise_type> h) {
+        uintptr_t state = 0;
+        if (__atomic_compare_exchange_n(&state_, &state, uintptr_t(&h.promise().waker_),
+                                        false, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+            return true;
+        }
+        __atomic_store_n(&state_, 0, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    void await_resume() {}
+};
+
+// Awaitable: resume once `wheel`'s timer reaches `deadline` (microseconds)
+struct Sleep {
+    TimerWheel& wheel_;
+    uint64_t deadline_;
+    Event done_ {};
+    SoftTimer timer_ {[](SoftTimer& t) { t.ctx<Event>()->signal(); }};
+
+    bool await_ready() { return wheel_.timer().now() >= deadline_; }
+
+    bool await_suspend(std::coroutine_handle<Task::promise_type> h) {
+        timer_.ctx_ = &done_; // (now that this has settled in the coroutine frame)
+        if (!done_.await_suspend(h)) { return false; }
+        wheel_.add(timer_, deadline_);
+        return true;
+    }
+
+    void await_resume() {}
+};
+
+inline Sleep sleepUntil(TimerWheel& wheel, uint64_t deadline) {
+    return {.wheel_ = wheel, .deadline_ = deadline};
+}
+
+inline Sleep sleepFor(TimerWheel& wheel, uint64_t us) {
+    return {.wheel_ = wheel, .deadline_ = wheel.timer().now() + us};
+}
+
+} // namespace rp2350
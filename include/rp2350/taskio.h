@@ -0,0 +1,102 @@
+#pragma once
+
+#include <platform.h>
+#include <rp2350/common.h>
+#include <rp2350/dma.h>
+#include <rp2350/interrupts.h>
+#include <rp2350/m33.h>
+#include <rp2350/task.h>
+#include <rp2350/uart.h>
+
+namespace rp2350 {
+
+// Awaitables for peripheral IRQs, for `Task`s (see `task.h`).  Each peripheral's IRQ
+// handler signals an `Event` and masks the interrupt source again, so a task is woken
+// once per `co_await`, and the IRQ stays quiet while nobody is waiting.
+
+// UART receive: `char c = co_await uartRead(uart0);`.  `initUARTRead` takes over the
+// UART's IRQ (and masks its other interrupt sources, like the TX one `UART::init`
+// enables).
+
+inline Event uartRxEvents[2];
+
+constexpr static uint32_t kUARTRxInts = (1u << 4) | (1u << 6); // RXIM, RTIM
+
+template <unsigned U> UART<U>& uartAt() {
+    return *(UART<U>*)(uintptr_t(0x40070000) + (U << 15));
+}
+
+template <unsigned U> void uartReadIRQ() {
+    atomicClr(&uartAt<U>().intMask, kUARTRxInts);
+    uartRxEvents[U].signal();
+}
+
+template <unsigned U> void initUARTRead(UART<U>& uart) {
+    overwrite(&uart.intMask, [](auto& _) { _.zero(); });
+    irqHandlers[uart.irqn()] = uartReadIRQ<U>;
+    m33.clrPendIRQ(uart.irqn());
+    m33.enableIRQ(uart.irqn());
+}
+
+template <unsigned U> struct UARTRead {
+    UART<U>& uart_;
+
+    bool await_ready() { return !((UART<U> volatile&)uart_).flags.rxEmpty; }
+
+    bool await_suspend(std::coroutine_handle<Task::promise_type> h) {
+        if (!uartRxEvents[U].await_suspend(h)) { return false; }
+        atomicSet(&uart_.intMask, kUARTRxInts); // fires right away if data's there
+        return true;
+    }
+
+    char await_resume() { return char(((UART<U> volatile&)uart_).data.data); }
+};
+
+template <unsigned U> UARTRead<U> uartRead(UART<U>& uart) { return {uart}; }
+
+// DMA completion: `co_await dmaDone(job)` for a `dmaCopy`, `dmaFill` or `DMAChain`.
+// Uses DMA_IRQ_1 (`examples/HDMI.cc` has DMA_IRQ_0); enabling a channel's interrupt
+// there once it's already finished fires at once, as `dmaSetup` leaves its raw status
+// bit to be set on completion.
+
+inline Event dmaDoneEvents[16];
+
+constexpr static unsigned kDMATaskIRQ = 1;
+
+inline void dmaDoneIRQ() {
+    auto& regs = dma.irqRegs(kDMATaskIRQ);
+    auto done = ((DMA::IRQ volatile&)regs).status;
+    dma.rawStatus = done;
+    atomicClr(&regs.enable, done);
+    for (unsigned ch = 0; ch < 16; ch++) {
+        if ((done >> ch) & 1) { dmaDoneEvents[ch].signal(); }
+    }
+}
+
+inline void initDMADone() {
+    auto irqn = DMA::kDMAIRQs[kDMATaskIRQ];
+    irqHandlers[irqn] = dmaDoneIRQ;
+    m33.clrPendIRQ(irqn);
+    m33.enableIRQ(irqn);
+}
+
+struct DMADone {
+    DMAJob& job_;
+
+    bool await_ready() { return job_.done(); }
+
+    bool await_suspend(std::coroutine_handle<Task::promise_type> h) {
+        auto ch = unsigned(job_.channel);
+        if (!dmaDoneEvents[ch].await_suspend(h)) { return false; }
+        atomicSet(&dma.irqRegs(kDMATaskIRQ).enable, 1u << ch);
+        return true;
+    }
+
+    // (The IRQ has cleared the raw status a chain's `done` goes by; no matter, as the
+    // IRQ also means it's finished)
+    void await_resume() { job_.release(); }
+};
+
+inline DMADone dmaDone(DMAJob& job) { return {job}; }
+
+} // namespace rp2350
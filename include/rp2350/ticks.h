@@ -41,16 +41,18 @@ inline auto& ticks = *(Ticks*)(0x40108000);
 [[gnu::noinline]] [[gnu::retain]] [[gnu::used]] [[gnu::section(".systext")]]
 inline void initSystemTicks() {
     // p569: SDK as well as Arm CPU expect nominal 1uS system ticks
-    ticks.proc0.control.enabled = false;
-    ticks.proc0.cycles.count = 12;
-    ticks.proc0.control.enabled = true;
-    ticks.proc1.control.enabled = false;
-    ticks.proc1.cycles.count = 12;
-    ticks.proc1.control.enabled = true;
+    overwrite(&ticks.proc0.control, [](auto& _) { _->enabled = false; });
+    overwrite(&ticks.proc0.cycles, [](auto& _) { _->count = 12; });
+    overwrite(&ticks.proc0.control, [](auto& _) { _->enabled = true; });
+    overwrite(&ticks.proc1.control, [](auto& _) { _->enabled = false; });
+    overwrite(&ticks.proc1.cycles, [](auto& _) { _->count = 12; });
+    overwrite(&ticks.proc1.control, [](auto& _) { _->enabled = true; });
 
     m33.rvr() = 1000;
-    m33.csr().enable = 1;
-    m33.csr().tickInt = 1;
+    update(&m33.csr(), [](auto& _) {
+        _->enable = 1;
+        _->tickInt = 1;
+    });
 }
 
 } // namespace rp2350
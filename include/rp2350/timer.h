@@ -0,0 +1,114 @@
+#pragma once
+
+#include <platform.h>
+#include <rp2350/common.h>
+#include <rp2350/insns.h>
+#include <rp2350/m33.h>
+#include <rp2350/resets.h>
+#include <rp2350/ticks.h>
+
+namespace rp2350 {
+
+// 12.8. System Timers
+//
+// TIMER0 and TIMER1 each count microseconds in 64 bits (from their tick generators;
+// see `initTimers`), and have four alarms which fire when the low 32 bits of the count
+// equal the alarm's value.
+struct Timer {
+    // Used by `sleepUntil`; leave this alarm alone otherwise
+    constexpr static unsigned kSleepAlarm = 3;
+
+    uint32_t timeHW;   // 0x00
+    uint32_t timeLW;   // 0x04
+    uint32_t timeHR;   // 0x08
+    uint32_t timeLR;   // 0x0c
+    uint32_t alarm[4]; // 0x10: writing arms the alarm
+    uint32_t armed;    // 0x20: write 1s to disarm
+    uint32_t timeRawH; // 0x24
+    uint32_t timeRawL; // 0x28
+    uint32_t dbgPause; // 0x2c
+    uint32_t pause;    // 0x30
+    uint32_t locked;   // 0x34
+    uint32_t source;   // 0x38
+    uint32_t intr;     // 0x3c: write 1s to clear
+    uint32_t inte;     // 0x40
+    uint32_t intf;     // 0x44
+    uint32_t ints;     // 0x48
+
+    // 0 for TIMER0 (0x400b0000), 1 for TIMER1 (0x400b8000)
+    unsigned index() const { return (uintptr_t(this) >> 15) & 1; }
+
+    // IRQ for alarm `n`; p.84: TIMER0_IRQ_0..3 are 0..3, TIMER1_IRQ_0..3 are 4..7
+    unsigned irqn(unsigned n) const { return (index() << 2) + n; }
+
+    // Microseconds since the timer started.  This reads the unlatched TIMERAWH/L, as
+    // the TIMEHR/TIMELR latch is shared by every reader (thread, ISRs, the other
+    // core); if the high word changes between the two reads, just try again.
+    uint64_t now() const {
+        auto volatile& self = *this;
+        uint32_t hi, lo;
+        do {
+            hi = self.timeRawH;
+            lo = self.timeRawL;
+        } while (hi != self.timeRawH);
+        return (uint64_t(hi) << 32) | lo;
+    }
+
+    // The low word alone: cheaper, for intervals under ~71 minutes
+    uint32_t now32() const { return ((Timer const volatile*)this)->timeRawL; }
+
+    void armAlarm(unsigned n, uint32_t t) { ((Timer volatile*)this)->alarm[n] = t; }
+    void disarmAlarm(unsigned n) { ((Timer volatile*)this)->armed = 1u << n; }
+    void clearAlarmIRQ(unsigned n) { ((Timer volatile*)this)->intr = 1u << n; }
+    void enableAlarmIRQ(unsigned n) { atomicSet(&inte, 1u << n); }
+    void disableAlarmIRQ(unsigned n) { atomicClr(&inte, 1u << n); }
+
+    // Sleep (WFE) until `now() >= t`.  The alarm's IRQ goes pending in the NVIC without
+    // being enabled there, and SEVONPEND turns that into a wakeup event.  Other events
+    // and interrupts can also end a WFE early; that just goes around the loop again.
+    void sleepUntil(uint64_t t, unsigned n = kSleepAlarm) {
+        update(&m33.scr(), [](auto& _) { _->sevOnPend = true; });
+        enableAlarmIRQ(n);
+        for (auto at = now(); at < t; at = now()) {
+            // Alarms only see the low word; go at most 2^31us at a time
+            auto left = t - at;
+            uint32_t step = left < (1ull << 31) ? uint32_t(left) : 1u << 31;
+            auto target = uint32_t(at) + step;
+            disarmAlarm(n);
+            clearAlarmIRQ(n);
+            m33.clrPendIRQ(irqn(n));
+            armAlarm(n, target);
+            // If the target went by while arming, the alarm won't fire until the low
+            // word comes around again
+            if (int32_t(target - now32()) <= 0) { continue; }
+            __wfe();
+        }
+        disarmAlarm(n);
+        disableAlarmIRQ(n);
+        clearAlarmIRQ(n);
+        m33.clrPendIRQ(irqn(n));
+    }
+
+    void sleepFor(uint64_t us, unsigned n = kSleepAlarm) { sleepUntil(now() + us, n); }
+};
+
+inline auto& timer0 = *(Timer*)(0x400b0000);
+inline auto& timer1 = *(Timer*)(0x400b8000);
+
+// Start both timers counting microseconds from 0
+[[gnu::noinline]] [[gnu::retain]] [[gnu::used]] [[gnu::section(".systext")]]
+inline void initTimers() {
+    // 8.5: a tick per 12 cycles of the 12MHz reference clock
+    constexpr static unsigned kCycles = unsigned(kXOSC / 1'000'000);
+    overwrite(&ticks.timer0.control, [](auto& _) { _->enabled = false; });
+    overwrite(&ticks.timer0.cycles, [](auto& _) { _->count = kCycles; });
+    overwrite(&ticks.timer0.control, [](auto& _) { _->enabled = true; });
+    overwrite(&ticks.timer1.control, [](auto& _) { _->enabled = false; });
+    overwrite(&ticks.timer1.cycles, [](auto& _) { _->count = kCycles; });
+    overwrite(&ticks.timer1.control, [](auto& _) { _->enabled = true; });
+
+    resets.unreset(Resets::Bit::TIMER0);
+    resets.unreset(Resets::Bit::TIMER1);
+}
+
+} // namespace rp2350
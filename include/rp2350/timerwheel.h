@@ -0,0 +1,262 @@
+#pragma once
+
+#include <platform.h>
+#include <rp2350/insns.h>
+#include <rp2350/m33.h>
+#include <rp2350/timer.h>
+
+namespace rp2350 {
+
+// Many software timers on one hardware alarm.
+//
+// A `SoftTimer` is an intrusive node: the owner embeds it (e.g. in a per-connection
+// struct), and points `ctx_` back at whatever the callback needs, so nothing is
+// allocated.  A `TimerWheel` keeps the pending ones in a hierarchical timing wheel
+// (Varghese & Lauck): `kLevels` levels of `kSlots` slots, each slot at level L
+// spanning 32^L microseconds.  A timer goes into the level whose span covers how far
+// away its deadline is, and is moved down ("cascaded") when time reaches its slot; so
+// adding and cancelling are O(1), and expiry work is per timer, not per tick.  Timers
+// due more than 2^30us (~18 minutes) ahead wait on a separate list, which is sorted
+// back into the wheel every 2^30us.
+//
+// The wheel runs from its alarm's IRQ, which fires callbacks for every timer now due
+// in one pass and then re-arms the alarm for the next one.  Callbacks run in that IRQ,
+// and may add or cancel timers (including their own); otherwise add and cancel from
+// thread code only, not other ISRs.  Wire it up with e.g.:
+//
+//     constinit TimerWheel gWheel {0, 0}; // TIMER0, alarm 0
+//
+//     irqHandlers[gWheel.irqn()] = [] { gWheel.onAlarm(); };
+//     gWheel.start();
+//
+// `Timer::kSleepAlarm` is taken by `Timer::sleepUntil`; use one of the others.
+
+struct SoftTimer {
+    using Callback = void (*)(SoftTimer&);
+
+    Callback fn_ {};
+    void* ctx_ {};
+    uint32_t periodUs_ {}; // nonzero: re-added this long after each deadline
+    uint64_t deadline_ {}; // in `Timer::now()` microseconds
+    SoftTimer* next_ {};
+    SoftTimer** pprev_ {}; // whichever pointer points here; null unless pending
+    uint8_t level_ {};
+    uint8_t slot_ {};
+
+    constexpr SoftTimer() = default;
+    constexpr explicit SoftTimer(Callback fn, void* ctx = nullptr,
+                                 uint32_t periodUs = 0)
+            : fn_(fn), ctx_(ctx), periodUs_(periodUs) {}
+
+    bool pending() const { return pprev_; }
+
+    template <class T> T* ctx() const { return (T*)ctx_; }
+};
+
+struct TimerWheel {
+    constexpr static unsigned kBits = 5;
+    constexpr static unsigned kSlots = 1u << kBits;
+    constexpr static unsigned kLevels = 6;
+    constexpr static unsigned kFar = kLevels; // `SoftTimer::level_` on the far list
+    constexpr static uint64_t kSpan = uint64_t(1) << (kLevels * kBits); // of the wheel
+    constexpr static uint64_t kNever = ~uint64_t(0);
+
+    unsigned timerIndex_;
+    unsigned alarm_;
+    uint64_t now_ {};           // every timer due at or before this has fired
+    uint64_t alarmAt_ {kNever}; // where the hardware alarm is set for
+    uint32_t occupied_[kLevels] {};
+    SoftTimer* slots_[kLevels][kSlots] {};
+    SoftTimer* far_ {};
+    bool inIRQ_ {};
+    uint32_t fired_ {};    // callbacks run
+    uint32_t cascaded_ {}; // timers moved down a level, or off the far list
+
+    constexpr TimerWheel(unsigned timerIndex, unsigned alarm)
+            : timerIndex_(timerIndex), alarm_(alarm) {}
+
+    Timer& timer() const {
+        return *(Timer*)(uintptr_t(0x400b0000) + (timerIndex_ << 15));
+    }
+    unsigned irqn() const { return timer().irqn(alarm_); }
+
+    // Enable the alarm IRQ; the handler must already be in `irqHandlers`
+    void start() {
+        now_ = timer().now();
+        timer().clearAlarmIRQ(alarm_);
+        timer().enableAlarmIRQ(alarm_);
+        m33.enableIRQ(irqn());
+    }
+
+    // (Re)schedule `t` to fire at `deadline`, or as soon as possible if that's passed
+    void add(SoftTimer& t, uint64_t deadline) {
+        lock();
+        if (t.pending()) { unlink(t); }
+        t.deadline_ = deadline;
+        place(t, now_ + 1);
+        if (t.deadline_ < alarmAt_) { rearm(); }
+        unlock();
+    }
+
+    void addIn(SoftTimer& t, uint64_t us) { add(t, timer().now() + us); }
+
+    // Stop `t` from firing; no-op if it isn't pending.  The alarm is left as it was,
+    // at worst waking the IRQ for nothing.
+    void cancel(SoftTimer& t) {
+        lock();
+        if (t.pending()) { unlink(t); }
+        unlock();
+    }
+
+    // The alarm IRQ handler
+    void onAlarm() {
+        timer().clearAlarmIRQ(alarm_);
+        inIRQ_ = true;
+        do {
+            advanceTo(timer().now());
+        } while (!arm());
+        inIRQ_ = false;
+    }
+
+    // Thread code and the IRQ share the wheel; keep the IRQ out while changing it.
+    // (Callbacks are already in the IRQ.)
+    void lock() {
+        if (inIRQ_) { return; }
+        m33.disableIRQ(irqn());
+        __dsb();
+        __isb();
+    }
+
+    void unlock() {
+        if (inIRQ_) { return; }
+        m33.enableIRQ(irqn());
+    }
+
+    // Set the alarm for the next thing to do, or under 2^31us away (alarms compare
+    // only the low word).  Returns false if that's already passed, in which case the
+    // alarm won't fire until the low word comes round again.
+    bool arm() {
+        auto next = nextEvent();
+        if (next == kNever) {
+            alarmAt_ = kNever;
+            timer().disarmAlarm(alarm_);
+            return true;
+        }
+        auto at = timer().now();
+        if (next > at && next - at >= (1u << 31)) { next = at + (1u << 31) - 1; }
+        alarmAt_ = next;
+        timer().armAlarm(alarm_, uint32_t(next));
+        return int32_t(uint32_t(next) - timer().now32()) > 0;
+    }
+
+    // From thread code (the IRQ loops on `arm` itself)
+    void rearm() {
+        if (inIRQ_) { return; }
+        if (!arm()) { m33.triggerIRQ(irqn()); }
+    }
+
+    void link(SoftTimer*& head, SoftTimer& t, unsigned level, unsigned slot) {
+        t.next_ = head;
+        if (head) { head->pprev_ = &t.next_; }
+        head = &t;
+        t.pprev_ = &head;
+        t.level_ = uint8_t(level);
+        t.slot_ = uint8_t(slot);
+    }
+
+    void unlink(SoftTimer& t) {
+        *t.pprev_ = t.next_;
+        if (t.next_) { t.next_->pprev_ = t.pprev_; }
+        if (t.level_ < kLevels && !slots_[t.level_][t.slot_]) {
+            occupied_[t.level_] &= ~(1u << t.slot_);
+        }
+        t.next_ = nullptr;
+        t.pprev_ = nullptr;
+    }
+
+    // File `t` by how far its deadline (taken as no earlier than `earliest`) is from
+    // `now_`: the highest bit in which they differ picks the level
+    void place(SoftTimer& t, uint64_t earliest) {
+        auto due = t.deadline_ > earliest ? t.deadline_ : earliest;
+        auto diff = due ^ now_;
+        auto level = diff ? unsigned(63 - __builtin_clzll(diff)) / kBits : 0;
+        if (level >= kLevels) {
+            link(far_, t, kFar, 0);
+            return;
+        }
+        auto slot = unsigned(due >> (level * kBits)) & (kSlots - 1);
+        link(slots_[level][slot], t, level, slot);
+        occupied_[level] |= 1u << slot;
+    }
+
+    // The next tick after `now_` at which a slot comes due, or the far list is due to
+    // be sorted back in.  Occupied slots at each level are all ahead of `now_`'s.
+    uint64_t nextEvent() const {
+        auto next = kNever;
+        for (unsigned level = 0; level < kLevels; level++) {
+            auto shift = level * kBits;
+            auto cur = unsigned(now_ >> shift) & (kSlots - 1);
+            auto ahead = occupied_[level] & ~((2u << cur) - 1);
+            if (!ahead) { continue; }
+            auto slot = unsigned(__builtin_ctz(unsigned(ahead)));
+            auto base = (now_ >> (shift + kBits)) << (shift + kBits);
+            auto at = base | (uint64_t(slot) << shift);
+            if (at < next) { next = at; }
+        }
+        if (far_) {
+            auto at = (now_ | (kSpan - 1)) + 1;
+            if (at < next) { next = at; }
+        }
+        return next;
+    }
+
+    // Fire everything due up to and including `to`, skipping straight over idle time
+    void advanceTo(uint64_t to) {
+        while (true) {
+            auto next = nextEvent();
+            if (next > to) { break; }
+            step(next);
+        }
+        if (to > now_) { now_ = to; }
+    }
+
+    void step(uint64_t tick) {
+        now_ = tick;
+        // Top down, as cascading a level can fill the slot due at the level below
+        if (!(tick & (kSpan - 1)) && far_) {
+            auto* list = far_;
+            far_ = nullptr;
+            while (auto* t = list) {
+                list = t->next_;
+                t->pprev_ = nullptr;
+                place(*t, tick);
+                ++cascaded_;
+            }
+        }
+        for (unsigned level = kLevels - 1; level; --level) {
+            auto shift = level * kBits;
+            if (tick & ((uint64_t(1) << shift) - 1)) { continue; }
+            auto& head = slots_[level][unsigned(tick >> shift) & (kSlots - 1)];
+            while (auto* t = head) {
+                unlink(*t);
+                place(*t, tick);
+                ++cascaded_;
+            }
+        }
+        // Everything left in this level-0 slot is due now.  Periodic timers go back
+        // in (at the next tick at the earliest) before their callback, which may
+        // cancel or re-add them.
+        auto& head = slots_[0][unsigned(tick) & (kSlots - 1)];
+        while (auto* t = head) {
+            unlink(*t);
+            if (t->periodUs_) {
+                t->deadline_ += t->periodUs_;
+                place(*t, tick + 1);
+            }
+            ++fired_;
+            t->fn_(*t);
+        }
+    }
+};
+
+} // namespace rp2350
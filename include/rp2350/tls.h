@@ -0,0 +1,69 @@
+#pragma once
+
+#include <platform.h>
+#include <rp2350/common.h>
+
+namespace rp2350 {
+
+// Per-core `thread_local` storage.
+//
+// Each core has a copy of every `thread_local` variable, so per-core state (allocator
+// caches, trace buffers, run queues) needs no lock, and no atomics: only its own core
+// ever touches it (other than through a pointer handed over on purpose).  ISRs see the
+// copy of the core they run on.
+//
+//     thread_local uint32_t tJobsRun;  // counts for whichever core runs the job
+//
+// `layout.ld` reserves a block per core in `.tls`, and `initTLS` fills one in from the
+// `.tdata` / `.tbss` template: `__reset` does core 0's before static initializers run,
+// and core 1 does its own on launch.  The compiler finds a variable through
+// `__aeabi_read_tp`, which picks the block by SIO CPUID; a few cycles per access, so
+// in a hot loop, take the variable's address once.
+//
+// `thread_local` objects are constructed on first use on each core, as usual; they're
+// never destroyed, as cores don't exit.
+
+// `core`'s TLS block: where `__aeabi_read_tp` points on that core
+inline uint8_t* tlsBlock(unsigned core) {
+    return (uint8_t*)(core ? &__tls_core1 : &__tls_core0);
+}
+
+// Set up `core`'s TLS block: initial values from `.tdata`, then zeroes for `.tbss`
+inline void initTLS(unsigned core) {
+    auto* tdata = (uint8_t const*)&__tdata_begin;
+    auto tdataSize = uintptr_t(&__tdata_end) - uintptr_t(tdata);
+    auto tbssSize = uintptr_t(&__tbss_end) - uintptr_t(&__tdata_end);
+    auto* block = tlsBlock(core) + uintptr_t(&__tls_offset);
+    __aeabi_memcpy(block, tdata, tdataSize);
+    __aeabi_memclr(block + tdataSize, tbssSize);
+}
+
+} // namespace rp2350
+
+#if !defined(RP2350_HOST) // (host builds use the host's own TLS)
+
+extern "C" {
+
+// The thread pointer (Arm RTABI): this core's TLS block.  Called from compiled code
+// with the guarantee that only r0 (and the flags) change, so it's written by hand.
+[[gnu::naked]] [[gnu::noinline]] [[gnu::retain]] [[gnu::used]]
+inline void* __aeabi_read_tp() {
+    asm volatile("mov r0, #0xd0000000\n"
+                 "ldr r0, [r0]\n" // SIO CPUID
+                 "cbnz r0, 1f\n"
+                 "movw r0, #:lower16:__tls_core0\n"
+                 "movt r0, #:upper16:__tls_core0\n"
+                 "bx lr\n"
+                 "1:\n"
+                 "movw r0, #:lower16:__tls_core1\n"
+                 "movt r0, #:upper16:__tls_core1\n"
+                 "bx lr\n");
+}
+
+// Registers a `thread_local` object's destructor; never needed, see above
+[[gnu::retain]] [[gnu::used]]
+inline int __cxa_thread_atexit(void (*)(void*), void*, void*) { return 0; }
+
+} // extern "C"
+
+#endif
@@ -2,6 +2,7 @@
 
 #include <platform.h>
 #include <rp2350/common.h>
+#include <rp2350/insns.h>
 #include <rp2350/pads.h>
 #include <rp2350/resets.h>
 
@@ -159,7 +160,7 @@ template <unsigned U> struct UART {
         intBaud.div = dint;
         fracBaud.div = dfrac;
         // These control register writes also latch the divisors set above
-        update(&lineControl, [&](auto& _) {
+        update(&lineControl, [](auto& _) {
             _.zero();
             _->fifoEnable = true;
             _->wordLength = WordLength::k8Bit;
@@ -188,6 +189,20 @@ template <unsigned U> struct UART {
         });
     }
 
+    // Blocking output, polling the TX FIFO; for simple or diagnostic output where the
+    // interrupt-driven path isn't set up.  `write` sends "\n" as "\r\n".
+    void put(char c) {
+        while (flags.txFull) { __nop(); }
+        overwrite(&data, [](auto& _, char c) { _->data = uint8_t(c); }, c);
+    }
+
+    void write(char const* s) {
+        for (; *s; ++s) {
+            if (*s == '\n') { put('\r'); }
+            put(*s);
+        }
+    }
+
     constexpr static unsigned irqn() {
         switch (U) {
         case 0: return 33;
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <platform.h>
+
+namespace rp2350 {
+
+// TMDS / TERC4 symbols and the RGB444 pixel format, as sent to the HSTX (section 12.11)
+// by the DVI / HDMI examples.  No hardware access here; this is just encoding.
+
+struct TERC {
+    unsigned code : 10;
+    constexpr operator unsigned() const { return unsigned(code); };
+};
+
+struct [[gnu::packed]] TMDS {
+    unsigned ch0 : 10 {};
+    unsigned ch1 : 10 {};
+    unsigned ch2 : 10 {};
+    unsigned     : 2;
+
+    constexpr uint32_t u32() const {
+        return (unsigned(ch2) << 20) | (unsigned(ch1) << 10) | (unsigned(ch0) << 0);
+    }
+
+    // Encode 6 bits (2 bits across 3 channels)
+    constexpr static TMDS control(uint8_t ch2, uint8_t ch1, uint8_t ch0) {
+        return {
+            .ch0 = kControl[ch0 & 0x03].code,
+            .ch1 = kControl[ch1 & 0x03].code,
+            .ch2 = kControl[ch2 & 0x03].code,
+        };
+    }
+
+    // Encode 6 bits (2 bits across 3 channels): CTL3..0, plus set CH0 ctl bits for sync
+    constexpr static TMDS control(uint8_t ch2, uint8_t ch1, bool vsync, bool hsync) {
+        uint8_t v = vsync ? 0b10 : 0b00;
+        uint8_t h = hsync ? 0b01 : 0b00;
+        return control(ch2, ch1, v | h);
+    }
+
+    constexpr static TMDS idle() { return control(0x00, 0x00, 0x00); }
+
+    constexpr static TMDS sync(bool vsync, bool hsync) {
+        return control(0x00, 0x00, vsync, hsync);
+    }
+
+    constexpr static TMDS hsync() { return control(0x00, 0x00, false, true); }
+
+    // For encoding 4 data bits
+    constexpr static TERC kTERC[16] {
+        {.code = 0b1010011100}, {.code = 0b1001100011}, {.code = 0b1011100100},
+        {.code = 0b1011100010}, {.code = 0b0101110001}, {.code = 0b0100011110},
+        {.code = 0b0110001110}, {.code = 0b0100111100}, {.code = 0b1011001100},
+        {.code = 0b0100111001}, {.code = 0b0110011100}, {.code = 0b1011000110},
+        {.code = 0b1010001110}, {.code = 0b1001110001}, {.code = 0b0101100011},
+        {.code = 0b1011000011},
+    };
+
+    // For encoding 2 control bits:
+    // CH0: D0=HSYNC  D1=VSYNC
+    // CH1: D0=CTL0   D1=CTL1
+    // CH2: D0=CTL2   D1=CTL3
+    constexpr static TERC kControl[4] {
+        {.code = 0b1101010100},
+        {.code = 0b0010101011},
+        {.code = 0b0101010100},
+        {.code = 0b1010101011},
+    };
+};
+static_assert(sizeof(TMDS) == 4);
+
+// RGB444, in a halfword (and aligned as one, so arrays of these can be filled and
+// copied a halfword or word at a time)
+struct [[gnu::packed]] [[gnu::aligned(2)]] Pixel {
+    unsigned b : 4 {};
+    unsigned g : 4 {};
+    unsigned r : 4 {};
+};
+static_assert(sizeof(Pixel) == 2 && alignof(Pixel) == 2);
+
+// Fill `count` pixels with `px`
+inline void fill16(Pixel* pixels, Pixel px, size_t count) {
+    ::fill16((uint16_t*)pixels, __builtin_bit_cast(uint16_t, px), count);
+}
+
+// Fill `pixels[begin, end)` with a test pattern for `line`: red and green follow
+// the line number, blue steps along the line every two pixels.  `end - begin` must be
+// a multiple of 4.
+[[gnu::always_inline]]
+inline void testPattern(unsigned line, Pixel* pixels, unsigned begin, unsigned end) {
+    auto i = begin;
+    Pixel px;
+    px.g = (line >> 4) & 0b1111;
+    px.r = line & 0b1111;
+    while (i < end) {
+        px.b = ((i & 0b1110) >> 1) << 1;
+        pixels[i++] = px;
+        pixels[i++] = px;
+        ++px.b;
+        pixels[i++] = px;
+        pixels[i++] = px;
+    }
+}
+
+} // namespace rp2350
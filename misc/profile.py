@@ -0,0 +1,108 @@
+"""
+Flat profile from a `profileDump` capture (see `include/rp2350/profile.h`).
+
+  python3 misc/profile.py build/examples/HDMI.elf capture.txt [--callers] [--top N]
+
+The capture is whatever was logged from the device, e.g. a serial console log; lines
+outside the "# profile ..." / "# profile end" block are ignored, and if there are
+several such blocks, the last one is used.  Symbols come from `llvm-nm` (override with
+$NM).  With `--callers`, samples in each function are also broken down by the function
+holding LR at the time, which for leaf functions is the caller.
+"""
+
+import argparse
+import bisect
+import collections
+import dataclasses
+import os
+import subprocess
+import sys
+
+@dataclasses.dataclass
+class Symbol:
+  addr: int
+  size: int
+  name: str
+
+class Symbols:
+  def __init__(self, elf: str) -> None:
+    nm = os.environ.get('NM', 'llvm-nm')
+    out = subprocess.run(
+      [nm, '--numeric-sort', '--print-size', '--defined-only', '--demangle', elf],
+      check=True, capture_output=True, text=True).stdout
+    self.syms: list[Symbol] = []
+    for line in out.splitlines():
+      # "addr size type name"; symbols without a size have one field fewer
+      parts = line.split(maxsplit=3)
+      if len(parts) != 4 or parts[2] not in 'tTwW':
+        continue
+      # Thumb function symbols have bit 0 set
+      self.syms.append(Symbol(int(parts[0], 16) & ~1, int(parts[1], 16), parts[3]))
+    self.syms.sort(key=lambda s: s.addr)
+    self.addrs = [s.addr for s in self.syms]
+
+  def lookup(self, addr: int) -> str:
+    addr &= ~1
+    i = bisect.bisect_right(self.addrs, addr) - 1
+    if i >= 0:
+      sym = self.syms[i]
+      if addr < sym.addr + max(sym.size, 1):
+        return sym.name
+    return f'<{addr:08x}>'
+
+@dataclasses.dataclass
+class Capture:
+  header: str
+  samples: list[tuple[int, int, int]]  # (pc, lr, count)
+
+def readCapture(lines: list[str]) -> Capture:
+  captures: list[Capture] = []
+  current: Capture | None = None
+  for line in lines:
+    line = line.strip()
+    if line == '# profile end':
+      if current:
+        captures.append(current)
+      current = None
+    elif line.startswith('# profile '):
+      current = Capture(line[2:], [])
+    elif current:
+      parts = line.split()
+      if len(parts) == 3:
+        current.samples.append((int(parts[0], 16), int(parts[1], 16), int(parts[2])))
+  if not captures:
+    sys.exit('no complete "# profile" block found')
+  return captures[-1]
+
+def main() -> None:
+  ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+  ap.add_argument('elf')
+  ap.add_argument('capture', nargs='?', help='default: stdin')
+  ap.add_argument('--callers', action='store_true', help='break down by LR function')
+  ap.add_argument('--top', type=int, default=40, help='functions to list')
+  args = ap.parse_args()
+
+  src = open(args.capture) if args.capture else sys.stdin
+  capture = readCapture(src.readlines())
+  syms = Symbols(args.elf)
+
+  self_: collections.Counter[str] = collections.Counter()
+  callers: dict[str, collections.Counter[str]] = collections.defaultdict(
+    collections.Counter)
+  for pc, lr, count in capture.samples:
+    fn = syms.lookup(pc)
+    self_[fn] += count
+    callers[fn][syms.lookup(lr)] += count
+
+  total = sum(self_.values())
+  print(capture.header)
+  print(f'{"%":>6} {"samples":>8}  function')
+  for fn, count in self_.most_common(args.top):
+    print(f'{100 * count / total:6.2f} {count:8}  {fn}')
+    if args.callers:
+      for caller, n in callers[fn].most_common(5):
+        if caller != fn:
+          print(f'{"":6} {n:8}    <- {caller}')
+
+if __name__ == '__main__':
+  main()
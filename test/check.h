@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdio.h>
+
+// Checks for the host tests (see `make test-host`).  Each test is a program of its
+// own: `CHECK`s report what failed and where, and carry on; `main` ends with
+// `return test::result("name")`, which is non-zero if any failed.
+
+namespace test {
+
+inline unsigned gChecks;
+inline unsigned gFailures;
+
+inline bool check(bool ok, char const* what, char const* file, int line) {
+    ++gChecks;
+    if (!ok && gFailures++ < 20) { printf("%s:%d: failed: %s\n", file, line, what); }
+    return ok;
+}
+
+inline int result(char const* name) {
+    printf("%-12s %s (%u checks, %u failed)\n", name, gFailures ? "FAILED" : "ok",
+           gChecks, gFailures);
+    return gFailures ? 1 : 0;
+}
+
+} // namespace test
+
+#define CHECK(x) ::test::check(bool(x), #x, __FILE__, __LINE__)
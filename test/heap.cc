@@ -0,0 +1,205 @@
+#include <check.h>
+#include <memory.h>
+#include <platform.h>
+
+// `Heap` over a static buffer: size-class reuse, coalescing, giving blocks back to
+// the top, and its stats kept consistent through a long random alloc / free sequence
+// (with each block's contents checked on free, which catches overlapping blocks).
+
+using rp2350::Heap;
+
+namespace {
+
+alignas(8) uint8_t arena[65536];
+
+size_t total(Heap const& heap) { return size_t(heap.end_ - heap.begin_); }
+
+// Every byte is in use, in a free list, or in the top
+bool accounted(Heap const& heap) {
+    auto s = heap.stats();
+    return s.inUse + s.free == total(heap);
+}
+
+void sizeClasses() {
+    Heap heap {arena, arena + sizeof(arena)};
+    auto* a = heap.alloc(24);
+    auto* b = heap.alloc(24);
+    CHECK(a && b && a != b);
+    CHECK(Heap::usable(a) == 24);
+    heap.free(a);
+    // Anything in the same class (17..24 bytes) gets the same block back...
+    CHECK(heap.alloc(17) == a);
+    heap.free(a);
+    // ...but not a neighbouring class
+    auto* c = heap.alloc(25);
+    CHECK(c != a && Heap::usable(c) == 32);
+    CHECK(heap.alloc(24) == a);
+    // Small blocks are never merged, or given back to the top
+    auto* top = heap.top_;
+    heap.free(a);
+    heap.free(b);
+    heap.free(c);
+    CHECK(heap.top_ == top);
+    CHECK(heap.alloc(48) != a); // (a and b together would do, if merged)
+    CHECK(accounted(heap));
+}
+
+void coalescing() {
+    Heap heap {arena, arena + sizeof(arena)};
+    auto* a = heap.alloc(1000);
+    auto* b = heap.alloc(2000);
+    auto* c = heap.alloc(3000);
+    auto* guard = heap.alloc(1000); // keeps the others away from the top
+    auto size = [](void* p) { return Heap::usable(p) + Heap::kHeader; };
+    auto abc = size(a) + size(b) + size(c);
+
+    // Neither neighbour free: `b` stays a block of its own
+    heap.free(b);
+    CHECK(heap.large_ == Heap::Block::of(b) && !heap.large_->next);
+    CHECK(heap.stats().free == size_t(heap.end_ - heap.top_) + size(b));
+    // Both neighbours free: one block
+    heap.free(a);
+    heap.free(c);
+    auto s = heap.stats();
+    CHECK(s.free == size_t(heap.end_ - heap.top_) + abc);
+    auto* all = heap.alloc(abc - Heap::kHeader);
+    CHECK(all == a);
+    CHECK(Heap::usable(all) == abc - Heap::kHeader);
+
+    // Splitting leaves the remainder free, and it merges back
+    heap.free(all);
+    auto* part = heap.alloc(500);
+    CHECK(part == a);
+    heap.free(part);
+    CHECK(heap.alloc(abc - Heap::kHeader) == a);
+    heap.free(guard);
+    CHECK(accounted(heap));
+}
+
+void loweringTheTop() {
+    Heap heap {arena, arena + sizeof(arena)};
+    auto* x = heap.alloc(1000);
+    auto* y = heap.alloc(1000);
+    auto* mid = heap.top_;
+    // The block below the top goes straight back to it
+    heap.free(y);
+    CHECK(heap.top_ == mid - (Heap::usable(x) + Heap::kHeader));
+    heap.free(x);
+    CHECK(heap.top_ == heap.begin_);
+
+    // Freed the other way round, the lower block waits in the free list until the
+    // upper one joins it
+    x = heap.alloc(1000);
+    y = heap.alloc(1000);
+    heap.free(x);
+    CHECK(heap.top_ == mid);
+    CHECK(heap.large_ != nullptr);
+    heap.free(y);
+    CHECK(heap.top_ == heap.begin_);
+    CHECK(heap.large_ == nullptr);
+    CHECK(heap.stats().free == total(heap) && heap.stats().fragmentation() == 0);
+}
+
+// Walk the blocks from the bottom to the top: each one's `prevSize` matches its
+// neighbour's size, no two free blocks sit side by side (they'd have been merged), and
+// none sits just below the top (it'd have been given back)
+bool wellFormed(Heap& heap) {
+    uint32_t prevSize = 0;
+    bool prevFree = false;
+    auto* b = (Heap::Block*)heap.begin_;
+    for (; (uint8_t*)b < heap.top_; b = b->after()) {
+        if (b->prevSize != prevSize || b->size() < Heap::kHeader + Heap::kAlign) {
+            return false;
+        }
+        if (!b->used() && prevFree) { return false; }
+        prevFree = !b->used();
+        prevSize = uint32_t(b->size());
+    }
+    return (uint8_t*)b == heap.top_ && heap.topPrevSize_ == prevSize && !prevFree;
+}
+
+uint32_t gRandom = 12345;
+
+uint32_t random() {
+    gRandom ^= gRandom << 13;
+    gRandom ^= gRandom >> 17;
+    gRandom ^= gRandom << 5;
+    return gRandom;
+}
+
+void randomized() {
+    constexpr unsigned kSlots = 200;
+    constexpr unsigned kSteps = 50000;
+    struct Live {
+        uint8_t* p;
+        size_t n;
+        uint8_t fill;
+    } live[kSlots] {};
+
+    Heap heap {arena, arena + sizeof(arena)};
+    size_t inUse = 0, peak = 0;
+    uint32_t allocs = 0, frees = 0, failures = 0;
+    bool intact = true, aligned = true, consistent = true;
+
+    auto release = [&](Live& l) {
+        for (size_t i = 0; i < l.n; i++) { intact &= l.p[i] == uint8_t(l.fill + i); }
+        inUse -= Heap::usable(l.p) + Heap::kHeader;
+        heap.free(l.p);
+        ++frees;
+        l.p = nullptr;
+    };
+
+    for (unsigned step = 0; step < kSteps; step++) {
+        auto& l = live[random() % kSlots];
+        if (l.p) {
+            release(l);
+        } else {
+            // Mostly small, some large (which won't always fit)
+            auto r = random();
+            auto n = size_t(r % 16 ? r % 300 : r % 6000);
+            l.p = (uint8_t*)heap.alloc(n);
+            if (!l.p) {
+                ++failures;
+                continue;
+            }
+            ++allocs;
+            aligned &= !(uintptr_t(l.p) % Heap::kAlign);
+            l.n = n;
+            l.fill = uint8_t(step);
+            for (size_t i = 0; i < n; i++) { l.p[i] = uint8_t(l.fill + i); }
+            inUse += Heap::usable(l.p) + Heap::kHeader;
+            if (inUse > peak) { peak = inUse; }
+        }
+
+        auto s = heap.stats();
+        consistent &= s.inUse == inUse && s.peak == peak && s.allocs == allocs &&
+                      s.frees == frees && s.failures == failures &&
+                      s.inUse + s.free == total(heap) && s.largestFree <= s.free &&
+                      s.fragmentation() <= 100;
+        if (!(step % 256)) { consistent &= wellFormed(heap); }
+    }
+    CHECK(intact);
+    CHECK(aligned);
+    CHECK(consistent);
+    CHECK(allocs > kSteps / 3 && failures);
+
+    // Everything back.  What's left below the top is the small lists' blocks (which
+    // never merge) and the free gaps between them.
+    for (auto& l : live) {
+        if (l.p) { release(l); }
+    }
+    CHECK(intact);
+    CHECK(wellFormed(heap));
+    auto s = heap.stats();
+    CHECK(s.inUse == 0 && s.peak == peak && s.free == total(heap));
+}
+
+} // namespace
+
+int main() {
+    sizeClasses();
+    coalescing();
+    loweringTheTop();
+    randomized();
+    return test::result("heap");
+}
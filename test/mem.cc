@@ -0,0 +1,92 @@
+#include <check.h>
+#include <platform.h>
+
+// The memory copy engine (`__aeabi_memcpy`, `__aeabi_memmove`) against a byte loop,
+// over every source and destination alignment (mod 8), lengths either side of its
+// word and 32-byte burst thresholds, and for `memmove`, overlaps in both directions.
+// Guard bytes around each destination catch writes outside it.
+
+namespace {
+
+constexpr size_t kMaxLength = 300;
+constexpr size_t kGuard = 16;
+constexpr size_t kSize = kMaxLength + 2 * kGuard + 8;
+
+alignas(8) uint8_t src[kSize];
+alignas(8) uint8_t dst[kSize];
+alignas(8) uint8_t want[kSize];
+
+void fillPattern(uint8_t* p, size_t n, uint8_t seed) {
+    for (size_t i = 0; i < n; i++) { p[i] = uint8_t(i * 7 + seed); }
+}
+
+bool same(uint8_t const* a, uint8_t const* b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] != b[i]) { return false; }
+    }
+    return true;
+}
+
+void copies() {
+    fillPattern(src, kSize, 1);
+    for (size_t srcOff = 0; srcOff < 8; srcOff++) {
+        for (size_t dstOff = 0; dstOff < 8; dstOff++) {
+            for (size_t n = 0; n <= kMaxLength; n++) {
+                auto s = kGuard + srcOff;
+                auto d = kGuard + dstOff;
+                fillPattern(dst, kSize, 0x80);
+                fillPattern(want, kSize, 0x80);
+                for (size_t i = 0; i < n; i++) { want[d + i] = src[s + i]; }
+                __aeabi_memcpy(dst + d, src + s, n);
+                if (!CHECK(same(dst, want, kSize))) {
+                    printf("  memcpy: src +%zu, dst +%zu, %zu bytes\n", srcOff, dstOff,
+                           n);
+                }
+            }
+        }
+    }
+}
+
+// Both pointers word-aligned, as `__aeabi_memcpy4` requires
+void alignedCopies() {
+    fillPattern(src, kSize, 2);
+    for (size_t n = 0; n <= kMaxLength; n++) {
+        fillPattern(dst, kSize, 0x80);
+        fillPattern(want, kSize, 0x80);
+        for (size_t i = 0; i < n; i++) { want[kGuard + i] = src[kGuard + i]; }
+        __aeabi_memcpy4(dst + kGuard, src + kGuard, n);
+        if (!CHECK(same(dst, want, kSize))) { printf("  memcpy4: %zu bytes\n", n); }
+    }
+}
+
+// Within one buffer, `dst` from 12 bytes below `src` to 12 above, so the ranges
+// overlap with `dst` both before and after `src` (and, at 0, coincide)
+void moves() {
+    for (size_t srcOff = 0; srcOff < 8; srcOff++) {
+        for (int shift = -12; shift <= 12; shift++) {
+            for (size_t n = 0; n <= kMaxLength; n++) {
+                auto s = kGuard + srcOff;
+                auto d = size_t(int(s) + shift);
+                fillPattern(dst, kSize, 3);
+                fillPattern(want, kSize, 3);
+                uint8_t tmp[kMaxLength];
+                for (size_t i = 0; i < n; i++) { tmp[i] = want[s + i]; }
+                for (size_t i = 0; i < n; i++) { want[d + i] = tmp[i]; }
+                __aeabi_memmove(dst + d, dst + s, n);
+                if (!CHECK(same(dst, want, kSize))) {
+                    printf("  memmove: src +%zu, shift %d, %zu bytes\n", srcOff, shift,
+                           n);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    copies();
+    alignedCopies();
+    moves();
+    return test::result("mem");
+}
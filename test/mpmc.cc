@@ -0,0 +1,114 @@
+#include <check.h>
+#include <mpmc.h>
+#include <platform.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+// `MpmcQueue`, lock-free and locked: three producer and three consumer threads (under
+// TSan; see `make test-host`) pass numbered items through a small queue.  Every item
+// must arrive exactly once, and each consumer must see any one producer's items in
+// the order they were pushed.
+
+using rp2350::MpmcQueue;
+
+namespace {
+
+constexpr unsigned kProducers = 3;
+constexpr unsigned kConsumers = 3;
+constexpr uint32_t kItems = 5000; // per producer
+
+// A test-and-set lock, standing in for `IRQMutex` on the host
+struct SpinLock {
+    bool held_ {};
+
+    void lock() {
+        while (__atomic_test_and_set(&held_, __ATOMIC_ACQUIRE)) { sched_yield(); }
+    }
+    void unlock() { __atomic_clear(&held_, __ATOMIC_RELEASE); }
+};
+
+template <class Q> struct Run {
+    Q& queue;
+    uint32_t popped {};          // by all consumers
+    uint8_t seen[kProducers][kItems] {};
+    bool ordered = true;
+
+    struct Thread {
+        Run* run;
+        uint32_t id;
+    };
+
+    static void* produce(void* arg) {
+        auto& [run, id] = *(Thread*)arg;
+        for (uint32_t i = 0; i < kItems; i++) {
+            while (!run->queue.tryPush(id << 24 | i)) { sched_yield(); }
+        }
+        return nullptr;
+    }
+
+    static void* consume(void* arg) {
+        auto& run = *((Thread*)arg)->run;
+        int32_t last[kProducers];
+        for (auto& l : last) { l = -1; }
+        bool ordered = true;
+        uint32_t x;
+        while (__atomic_load_n(&run.popped, __ATOMIC_RELAXED) < kProducers * kItems) {
+            if (!run.queue.tryPop(x)) {
+                sched_yield();
+                continue;
+            }
+            __atomic_fetch_add(&run.popped, 1, __ATOMIC_RELAXED);
+            auto from = x >> 24, i = x & 0xffffff;
+            if (from >= kProducers || i >= kItems) {
+                ordered = false;
+                continue;
+            }
+            ordered &= int32_t(i) > last[from];
+            last[from] = int32_t(i);
+            __atomic_fetch_add(&run.seen[from][i], 1, __ATOMIC_RELAXED);
+        }
+        if (!ordered) { __atomic_store_n(&run.ordered, false, __ATOMIC_RELAXED); }
+        return nullptr;
+    }
+
+    void go() {
+        pthread_t threads[kProducers + kConsumers];
+        Thread args[kProducers + kConsumers];
+        for (uint32_t t = 0; t < kProducers + kConsumers; t++) {
+            args[t] = {this, t < kProducers ? t : t - kProducers};
+            pthread_create(&threads[t], nullptr, t < kProducers ? produce : consume,
+                           &args[t]);
+        }
+        for (auto& t : threads) { pthread_join(t, nullptr); }
+
+        bool once = true;
+        for (auto& from : seen) {
+            for (auto n : from) { once &= n == 1; }
+        }
+        CHECK(once);
+        CHECK(ordered);
+        CHECK(popped == kProducers * kItems);
+        CHECK(queue.empty());
+    }
+};
+
+MpmcQueue<uint32_t, 16> gQueue;
+SpinLock gLock;
+MpmcQueue<uint32_t, 16, SpinLock> gLockedQueue {&gLock};
+
+} // namespace
+
+int main() {
+    // Single-threaded basics first: capacity, and the `full` count
+    MpmcQueue<uint32_t, 4> q;
+    uint32_t x;
+    for (uint32_t i = 0; i < 4; i++) { CHECK(q.tryPush(i)); }
+    CHECK(!q.tryPush(4) && q.full() == 1 && q.size() == 4);
+    for (uint32_t i = 0; i < 4; i++) { CHECK(q.tryPop(x) && x == i); }
+    CHECK(!q.tryPop(x) && q.empty());
+
+    Run<decltype(gQueue)> {gQueue}.go();
+    Run<decltype(gLockedQueue)> {gLockedQueue}.go();
+    return test::result("mpmc");
+}
@@ -0,0 +1,115 @@
+#include <check.h>
+#include <platform.h>
+#include <pool.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+// `Pool`: four threads (under TSan; see `make test-host`) allocate and free blocks of
+// a pool too small for all of them at once.  No block may be handed out to two holders
+// at a time, and afterwards `inUse`, `highWater` and `failures` must agree with what
+// the threads counted.
+
+using rp2350::Pool;
+
+namespace {
+
+constexpr unsigned kThreads = 4;
+constexpr unsigned kBlocks = 8;
+constexpr unsigned kHold = 3;       // blocks each thread holds at once, at most
+constexpr unsigned kRounds = 20000; // per thread
+
+struct Block {
+    uint32_t owner;
+    uint32_t round;
+};
+
+Pool<Block, kBlocks> gPool;
+uint32_t gOwner[kBlocks]; // thread (+ 1) holding each block, 0 if none
+
+struct Thread {
+    uint32_t id;
+    uint32_t allocs;
+    uint32_t failures;
+    uint32_t doubled; // blocks found already held by someone else
+    uint32_t corrupt; // blocks whose contents changed while held
+};
+
+unsigned indexOf(Block* b) {
+    return unsigned((uint8_t*)b - gPool.storage_[0]) / sizeof(Block);
+}
+
+void* run(void* arg) {
+    auto& t = *(Thread*)arg;
+    Block* held[kHold] {};
+    for (uint32_t r = 0; r < kRounds; r++) {
+        auto& slot = held[r % kHold];
+        if (slot) {
+            if (slot->owner != t.id || slot->round != r - kHold) { t.corrupt++; }
+            __atomic_store_n(&gOwner[indexOf(slot)], 0, __ATOMIC_RELAXED);
+            gPool.free(slot);
+            slot = nullptr;
+        }
+        slot = (Block*)gPool.alloc();
+        if (!slot) {
+            t.failures++;
+            sched_yield();
+            continue;
+        }
+        t.allocs++;
+        *slot = {t.id, r};
+        uint32_t none = 0;
+        if (!__atomic_compare_exchange_n(&gOwner[indexOf(slot)], &none, t.id + 1, false,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            t.doubled++;
+        }
+    }
+    for (auto* b : held) {
+        if (b) { __atomic_store_n(&gOwner[indexOf(b)], 0, __ATOMIC_RELAXED); }
+        gPool.free(b);
+    }
+    return nullptr;
+}
+
+} // namespace
+
+int main() {
+    // Single-threaded basics first: exhaustion, counts, and reuse of freed blocks
+    Pool<Block, 4> p;
+    void* got[4];
+    for (auto& g : got) { CHECK((g = p.alloc())); }
+    CHECK(!p.alloc() && p.failures() == 1);
+    CHECK(p.inUse() == 4 && p.highWater() == 4);
+    p.free(got[2]);
+    CHECK(p.inUse() == 3 && p.highWater() == 4);
+    CHECK(p.alloc() == got[2]);
+    for (auto* g : got) { p.free(g); }
+    CHECK(p.inUse() == 0 && p.highWater() == 4);
+
+    pthread_t threads[kThreads];
+    Thread args[kThreads] {};
+    for (uint32_t i = 0; i < kThreads; i++) {
+        args[i].id = i;
+        pthread_create(&threads[i], nullptr, run, &args[i]);
+    }
+    for (auto& t : threads) { pthread_join(t, nullptr); }
+
+    uint32_t allocs = 0, failures = 0;
+    for (auto& t : args) {
+        CHECK(t.doubled == 0);
+        CHECK(t.corrupt == 0);
+        allocs += t.allocs;
+        failures += t.failures;
+    }
+    CHECK(allocs + failures == kThreads * kRounds);
+    CHECK(gPool.failures() == failures);
+    CHECK(gPool.inUse() == 0);
+    CHECK(gPool.highWater() >= kHold && gPool.highWater() <= kBlocks);
+
+    // Every block is back: the pool hands out all of them, and then no more
+    void* all[kBlocks];
+    for (auto& b : all) { CHECK((b = gPool.alloc())); }
+    CHECK(!gPool.alloc() && gPool.inUse() == kBlocks && gPool.highWater() == kBlocks);
+    for (auto* b : all) { gPool.free(b); }
+    return test::result("pool");
+}
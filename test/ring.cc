@@ -0,0 +1,91 @@
+#include <check.h>
+#include <platform.h>
+#include <ring.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+// `SpscRing`: its counters and region handling on one thread, then a producer and a
+// consumer thread (under TSan; see `make test-host`) moving a numbered sequence
+// through a small ring, one item and a span at a time, which must arrive in order.
+
+using rp2350::Span;
+using rp2350::SpscRing;
+
+namespace {
+
+void singleThreaded() {
+    SpscRing<uint32_t, 8> ring;
+    CHECK(ring.empty() && !ring.full());
+    for (uint32_t i = 0; i < 8; i++) { CHECK(ring.push(i)); }
+    CHECK(ring.full() && ring.highWater() == 8);
+    CHECK(!ring.push(8) && ring.overflows() == 1);
+
+    // Wrap around the end: the regions stop there, and `read` / `write` go in two
+    uint32_t x;
+    for (uint32_t i = 0; i < 5; i++) { CHECK(ring.pop(x) && x == i); }
+    CHECK(ring.writeRegion().size() == 5);
+    uint32_t in[] {8, 9, 10, 11, 12, 13};
+    CHECK(ring.write({in, 6}) == 5 && ring.overflows() == 2);
+    CHECK(ring.readRegion().size() == 3);
+    uint32_t out[8] {};
+    CHECK(ring.read({out, 8}) == 8);
+    bool ordered = true;
+    for (uint32_t i = 0; i < 8; i++) { ordered &= out[i] == i + 5; }
+    CHECK(ordered);
+    CHECK(ring.empty() && !ring.pop(x) && ring.readRegion().empty());
+}
+
+constexpr uint32_t kItems = 20000;
+
+SpscRing<uint32_t, 16> gRing;
+
+// Alternates between single items and spans of up to 7, to mix wrapping and not
+void* producer(void*) {
+    uint32_t next = 0;
+    while (next < kItems) {
+        if (next & 1) {
+            uint32_t span[7];
+            auto n = 1 + next % 7;
+            if (n > kItems - next) { n = kItems - next; }
+            for (uint32_t i = 0; i < n; i++) { span[i] = next + i; }
+            next += gRing.write({span, n});
+        } else if (gRing.push(next)) {
+            ++next;
+        }
+        sched_yield();
+    }
+    return nullptr;
+}
+
+bool gInOrder = true;
+
+void* consumer(void*) {
+    uint32_t expect = 0;
+    while (expect < kItems) {
+        uint32_t span[5];
+        auto n = (expect & 2) ? gRing.read({span, 5}) : gRing.pop(span[0]) ? 1u : 0u;
+        for (uint32_t i = 0; i < n; i++) { gInOrder &= span[i] == expect++; }
+        sched_yield();
+    }
+    return nullptr;
+}
+
+void twoThreads() {
+    pthread_t p, c;
+    pthread_create(&c, nullptr, consumer, nullptr);
+    pthread_create(&p, nullptr, producer, nullptr);
+    pthread_join(p, nullptr);
+    pthread_join(c, nullptr);
+    CHECK(gInOrder);
+    CHECK(gRing.empty());
+    CHECK(gRing.highWater() <= 16);
+}
+
+} // namespace
+
+int main() {
+    singleThreaded();
+    twoThreads();
+    return test::result("ring");
+}